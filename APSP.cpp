@@ -0,0 +1,231 @@
+// michael9090124@gmail.com
+
+#include "APSP.h"
+#include "Graph.h"
+#include "Algorithms.h"
+#include "CSRGraph.h"
+#include "CompressedGraph.h"
+#include "ThreadPool.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace graph {
+
+static const int TILE = 128;            // 128 x 128 ints = 64 KB, three tiles fit in L2
+static const int FW_INF = 0x3fffffff;   // INF + INF does not overflow
+static const int FW_LIMIT = FW_INF / 2; // Anything above is derived from FW_INF: unreachable
+
+// c[j] = min(c[j], a + b[j]) for j in [0, count)
+static inline void relaxRow(int* c, const int* b, int a, int count) {
+    int j = 0;
+#ifdef __AVX2__
+    __m256i va = _mm256_set1_epi32(a);
+    for (; j + 8 <= count; j += 8) {
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + j));
+        __m256i vc = _mm256_loadu_si256((const __m256i*)(c + j));
+        _mm256_storeu_si256((__m256i*)(c + j), _mm256_min_epi32(vc, _mm256_add_epi32(va, vb)));
+    }
+#endif
+    for (; j < count; j++) {
+        int candidate = a + b[j];
+        c[j] = candidate < c[j] ? candidate : c[j];
+    }
+}
+
+// Floyd-Warshall steps on a tile in the pivot row or column: k outermost, so c may alias
+// a or b (row k and column k do not change in step k).
+static void tileSteps(int* c, const int* a, const int* b, int rows, int cols, int depth, int stride) {
+    for (int k = 0; k < depth; k++) {
+        const int* bk = b + (long long)k * stride;
+        for (int i = 0; i < rows; i++) {
+            int aik = a[(long long)i * stride + k];
+            if (aik > FW_LIMIT) continue;   // No path through k
+            relaxRow(c + (long long)i * stride, bk, aik, cols);
+        }
+    }
+}
+
+// Min-plus product c = min(c, a * b) for a tile independent of a and b: i outermost, so
+// row i of c stays in L1 while the rows of b stream past it.
+static void tileMinPlus(int* c, const int* a, const int* b, int rows, int cols, int depth, int stride) {
+    for (int i = 0; i < rows; i++) {
+        int* ci = c + (long long)i * stride;
+        const int* ai = a + (long long)i * stride;
+        for (int k = 0; k < depth; k++) {
+            if (ai[k] > FW_LIMIT) continue;
+            relaxRow(ci, b + (long long)k * stride, ai[k], cols);
+        }
+    }
+}
+
+// Floyd-Warshall inside the pivot tile. A negative cycle whose largest vertex is k shows
+// up as d[k][k] < 0 before step k; stopping there keeps every value bounded (with a
+// negative cycle, Floyd-Warshall values can shrink exponentially and overflow).
+static bool pivotSteps(int* c, int size, int stride) {
+    for (int k = 0; k < size; k++) {
+        const int* ck = c + (long long)k * stride;
+        if (ck[k] < 0) return false;
+        for (int i = 0; i < size; i++) {
+            int cik = c[(long long)i * stride + k];
+            if (cik > FW_LIMIT) continue;
+            relaxRow(c + (long long)i * stride, ck, cik, size);
+        }
+    }
+    return true;
+}
+
+struct BlockedFW {
+    int* d;
+    int n;
+    int tiles;
+
+    int* tile(int ti, int tj) const { return d + (long long)ti * TILE * n + (long long)tj * TILE; }
+    int extent(int t) const { return n - t * TILE < TILE ? n - t * TILE : TILE; }
+
+    // Returns false if the pivot tile revealed a negative cycle
+    bool round(int kb) const {
+        int* pivot = tile(kb, kb);
+        int depth = extent(kb);
+        if (!pivotSteps(pivot, depth, n)) {
+            return false;
+        }
+
+        // Pivot row and column: tiles t < tiles are in row kb, the others in column kb
+        parallel_for(0, 2 * tiles, [&](long long begin, long long end) {
+            for (long long t = begin; t < end; t++) {
+                int other = (int)(t < tiles ? t : t - tiles);
+                if (other == kb) continue;
+                if (t < tiles) {
+                    int* c = tile(kb, other);
+                    tileSteps(c, pivot, c, depth, extent(other), depth, n);
+                } else {
+                    int* c = tile(other, kb);
+                    tileSteps(c, c, pivot, extent(other), depth, depth, n);
+                }
+            }
+        }, 1);
+
+        // Every other tile
+        parallel_for(0, (long long)tiles * tiles, [&](long long begin, long long end) {
+            for (long long t = begin; t < end; t++) {
+                int ti = (int)(t / tiles), tj = (int)(t % tiles);
+                if (ti == kb || tj == kb) continue;
+                tileMinPlus(tile(ti, tj), tile(ti, kb), tile(kb, tj), extent(ti), extent(tj), depth, n);
+            }
+        }, 1);
+        return true;
+    }
+};
+
+template <class GraphT>
+static void floydWarshall(const GraphT& g, int* dist) {
+    int n = g.getNumVertices();
+    long long maxWeight = 0;
+    for (int u = 0; u < n; u++) {
+        for (Edge e : g.edges(u)) {
+            long long w = e.w < 0 ? -(long long)e.w : e.w;
+            if (w > maxWeight) maxWeight = w;
+        }
+    }
+    if (maxWeight * (n > 1 ? n - 1 : 1) >= FW_LIMIT) {
+        throw "Distances too large for Floyd-Warshall!";
+    }
+
+    parallel_for(0, n, [&](long long begin, long long end) {
+        for (long long u = begin; u < end; u++) {
+            int* row = dist + u * n;
+            for (int v = 0; v < n; v++) {
+                row[v] = FW_INF;
+            }
+            row[u] = 0;
+            for (Edge e : g.edges((int)u)) {
+                if (e.w < row[e.dst]) row[e.dst] = e.w; // Keep the lightest parallel edge
+            }
+        }
+    });
+
+    BlockedFW fw = {dist, n, (n + TILE - 1) / TILE};
+    for (int kb = 0; kb < fw.tiles; kb++) {
+        if (!fw.round(kb)) {
+            throw "Graph contains a negative cycle!";
+        }
+    }
+    parallel_for(0, (long long)n * n, [&](long long begin, long long end) {
+        for (long long i = begin; i < end; i++) {
+            if (dist[i] > FW_LIMIT) dist[i] = DIST_INF;
+        }
+    });
+}
+
+// Sources in chunks on the thread pool; every chunk is one dijkstraBatch call
+template <class GraphT>
+static void allDijkstra(const GraphT& g, int* dist) {
+    int n = g.getNumVertices();
+    for (int u = 0; u < n; u++) {
+        for (Edge e : g.edges(u)) {
+            if (e.w < 0) {
+                throw "Dijkstra's algorithm does'nt support negative weights!";
+            }
+        }
+    }
+    int* sources = new int[n > 0 ? n : 1];
+    for (int v = 0; v < n; v++) {
+        sources[v] = v;
+    }
+    BasicAlgorithms<GraphT> alg(g);
+    parallel_for(0, n, [&](long long begin, long long end) {
+        alg.dijkstraBatch(sources + begin, (int)(end - begin), dist + begin * n);
+    }, 64);
+    delete[] sources;
+}
+
+template <class GraphT>
+APSPMethod chooseAPSPMethod(const GraphT& g) {
+    int n = g.getNumVertices();
+    long long m = 0;
+    for (int u = 0; u < n; u++) {
+        for (Edge e : g.edges(u)) {
+            if (e.w < 0) return APSP_FLOYD_WARSHALL;
+            m++;
+        }
+    }
+    // Floyd-Warshall costs n^3 min-plus steps, the searches about n * m * log n heap
+    // operations. Measured on random graphs, one search step costs about 3 AVX2 min-plus
+    // steps and half a scalar one (without SSE4.1 / AVX2 there is no vector min of ints).
+#ifdef __AVX2__
+    const double SEARCH_COST = 3.0;
+#else
+    const double SEARCH_COST = 0.5;
+#endif
+    int logN = 1;
+    while ((1 << logN) < n) logN++;
+    return (double)m * logN * SEARCH_COST >= (double)n * n ? APSP_FLOYD_WARSHALL : APSP_DIJKSTRA;
+}
+
+template <class GraphT>
+void allPairsShortestPaths(const GraphT& g, int* dist, APSPMethod method) {
+    if (method == APSP_AUTO) {
+        method = chooseAPSPMethod(g);
+    }
+    if (method == APSP_FLOYD_WARSHALL) {
+        floydWarshall(g, dist);
+    } else {
+        allDijkstra(g, dist);
+    }
+}
+
+// Explicit instantiations for the supported graph storages
+template void allPairsShortestPaths<Graph>(const Graph&, int*, APSPMethod);
+template void allPairsShortestPaths<UnweightedGraph>(const UnweightedGraph&, int*, APSPMethod);
+template void allPairsShortestPaths<InterleavedGraph>(const InterleavedGraph&, int*, APSPMethod);
+template void allPairsShortestPaths<CSRGraph>(const CSRGraph&, int*, APSPMethod);
+template void allPairsShortestPaths<CompressedGraph>(const CompressedGraph&, int*, APSPMethod);
+template APSPMethod chooseAPSPMethod<Graph>(const Graph&);
+template APSPMethod chooseAPSPMethod<UnweightedGraph>(const UnweightedGraph&);
+template APSPMethod chooseAPSPMethod<InterleavedGraph>(const InterleavedGraph&);
+template APSPMethod chooseAPSPMethod<CSRGraph>(const CSRGraph&);
+template APSPMethod chooseAPSPMethod<CompressedGraph>(const CompressedGraph&);
+
+} // namespace graph
@@ -0,0 +1,32 @@
+// michael9090124@gmail.com
+
+#ifndef APSP_H
+#define APSP_H
+
+#include "Algorithms.h"
+
+namespace graph {
+
+enum APSPMethod {
+    APSP_AUTO,              // Floyd-Warshall for dense graphs or negative weights, Dijkstra otherwise
+    APSP_FLOYD_WARSHALL,    // O(n^3), cache-blocked and vectorized, handles negative weights
+    APSP_DIJKSTRA           // One search per source, O(n * m log n), non-negative weights only
+};
+
+// All-pairs shortest paths for small graphs (the matrix has n^2 entries).
+// dist receives n x n distances, row u holding the distances from u (DIST_INF for
+// unreachable pairs). Both backends run on the shared thread pool (see setNumThreads).
+// Floyd-Warshall works on 128 x 128 tiles of dist: each round updates the diagonal tile,
+// then its row and column, then every other tile with a min-plus product (AVX2 when built
+// with make AVX2=1). It throws if the graph has a negative cycle (an undirected graph
+// with a negative edge has one) or if distances could exceed 2^29.
+template <class GraphT>
+void allPairsShortestPaths(const GraphT& g, int* dist, APSPMethod method = APSP_AUTO);
+
+// The backend APSP_AUTO picks for g
+template <class GraphT>
+APSPMethod chooseAPSPMethod(const GraphT& g);
+
+}
+
+#endif
@@ -1,19 +1,56 @@
 // michael9090124@gmail.com
 
 #include "Algorithms.h"
+#include "CSRGraph.h"
+#include "CompressedGraph.h"
 #include "DataStructures.h"
+#include "PerfCounters.h"
 #include <iostream>
 
 namespace graph {
 
-Algorithms::Algorithms(Graph& graph) : g(graph) {}
+// Operation counting, compiled out unless GRAPH_ENABLE_STATS is defined
+#ifdef GRAPH_ENABLE_STATS
+#define STAT_ADD(field, amount) (counters.field += (amount))
+#define STAT_MAX(field, value) (counters.field = (value) > counters.field ? (value) : counters.field)
+#else
+#define STAT_ADD(field, amount) ((void)0)
+#define STAT_MAX(field, value) ((void)0)
+#endif
+
+bool algorithmStatsEnabled() {
+#ifdef GRAPH_ENABLE_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+template <class GraphT>
+BasicAlgorithms<GraphT>::BasicAlgorithms(const GraphT& graph) : g(graph) {}
+
+// Adjacency entries of g for the perf counter report (only counted when enabled)
+template <class GraphT>
+static long long perfEdgeCount(const GraphT& g) {
+    if (!perfCountersEnabled()) {
+        return 0;
+    }
+    long long total = 0;
+    for (int v = 0; v < g.getNumVertices(); v++) {
+        total += g.getSize(v);
+    }
+    return total;
+}
 
 // Performs Breadth-First Search (BFS) starting from 'start' vertex
-Graph Algorithms::bfs(int start) {
+template <class GraphT>
+Graph BasicAlgorithms<GraphT>::bfs(int start, AlgorithmStats* stats) const {
+    PerfScope perf("bfs", g.getNumVertices(), perfEdgeCount(g));
     int n = g.getNumVertices();      // Number of vertices
     if (start < 0 || start >= n) {
         throw "Invalid starting vertex!";
     }
+    AlgorithmStats counters;        // Operation counts (only updated with GRAPH_ENABLE_STATS)
     Graph tree(n);
     bool* visited = new bool[n]();  // Tracks visited vertices
     Queue q(n);                     // Queue for managing vertices to visit
@@ -22,56 +59,69 @@ Graph Algorithms::bfs(int start) {
 
     while (!q.isEmpty()) {          // While the queue is not empty
         int u = q.dequeue();            // Dequeue a vertex
-        for (int i = 0; i < g.getSize(u); i++) {    // For each neighbor of vertex u
-            int v = g.getAdjList(u)[i]; // Get neighbor v
+        STAT_ADD(verticesVisited, 1);
+        for (Edge e : g.edges(u)) { // For each neighbor of vertex u
+            STAT_ADD(edgesScanned, 1);
+            int v = e.dst;          // Get neighbor v
             if (!visited[v]) {      // If neighbor v has not been visited
                 visited[v] = true;  // Mark v as visited
                 q.enqueue(v);       // Enqueue v
-                tree.addEdge(u, v, g.getWeights(u)[i]); // Add edge to BFS tree
+                tree.addEdge(u, v, e.w); // Add edge to BFS tree
             }
         }
     }
     delete[] visited;               // Free memory
+    if (stats != nullptr) *stats = counters;
     return tree;                    // Return BFS tree
 }
 
 // Performs Depth-First Search (DFS) starting from 'start' vertex
-Graph Algorithms::dfs(int start) {
+template <class GraphT>
+Graph BasicAlgorithms<GraphT>::dfs(int start, AlgorithmStats* stats) const {
+    PerfScope perf("dfs", g.getNumVertices(), perfEdgeCount(g));
     int n = g.getNumVertices();      // Number of vertices
     if (start < 0 || start >= n) {
         throw "Invalid starting vertex!";
     }
 
+    AlgorithmStats counters;        // Operation counts (only updated with GRAPH_ENABLE_STATS)
     Graph tree(n);                  // DFS tree/forest result graph
     bool* visited = new bool[n]();     // Tracks visited vertices
 
     // Initial call to recursive helper
-    Algorithms::dfsUtil(start, visited, tree);
+    dfsUtil(start, visited, tree, counters);
 
     // Handle other connected components
     for (int u = 0; u < n; ++u) {
         if (!visited[u]) {
-            Algorithms::dfsUtil(u, visited, tree); // Start DFS from this component
+            dfsUtil(u, visited, tree, counters); // Start DFS from this component
         }
     }
     delete[] visited;
+    if (stats != nullptr) *stats = counters;
     return tree;                    // Return DFS tree/forest
 }
 
 // Recursive helper function for DFS
-void Algorithms::dfsUtil(int u, bool* visited, Graph& tree) {
+template <class GraphT>
+void BasicAlgorithms<GraphT>::dfsUtil(int u, bool* visited, Graph& tree, AlgorithmStats& counters) const {
+    (void)counters;                 // Unused without GRAPH_ENABLE_STATS
     visited[u] = true;              // Mark current vertex as visited
-    for (int i = 0; i < g.getSize(u); i++) { // For each neighbor
-        int v = g.getAdjList(u)[i]; // Get neighbor v
+    STAT_ADD(verticesVisited, 1);
+    for (Edge e : g.edges(u)) {     // For each neighbor
+        STAT_ADD(edgesScanned, 1);
+        int v = e.dst;              // Get neighbor v
         if (!visited[v]) {          // If neighbor not visited
-            tree.addEdge(u, v, g.getWeights(u)[i]); // Add edge to DFS tree
-            Algorithms::dfsUtil(v, visited, tree); // Recursive call
+            tree.addEdge(u, v, e.w); // Add edge to DFS tree
+            dfsUtil(v, visited, tree, counters); // Recursive call
         }
     }
 }
 
 // Dijkstra's algorithm for shortest paths
-Graph Algorithms::dijkstra(int start) {
+template <class GraphT>
+Graph BasicAlgorithms<GraphT>::dijkstra(int start, AlgorithmStats* stats) const {
+    PerfScope perf("dijkstra", g.getNumVertices(), perfEdgeCount(g));
     int n = g.getNumVertices();     // Number of vertices
     if (start < 0 || start >= n) {
         throw "Invalid starting vertex!";
@@ -79,13 +129,14 @@ Graph Algorithms::dijkstra(int start) {
 
     // Check for negative weights
     for (int u = 0; u < n; u++) {
-        for (int i = 0; i < g.getSize(u); i++) {
-            if (g.getWeights(u)[i] < 0) {
+        for (Edge e : g.edges(u)) {
+            if (e.w < 0) {
                 throw "Dijkstra's algorithm does'nt support negative weights!";
             }
         }
     }
 
+    AlgorithmStats counters;      // Operation counts (only updated with GRAPH_ENABLE_STATS)
     const int INF = 99999999;     // Represents infinity
     int* dist = new int[n];       // dist[i] = shortest distance from start
     int* parent = new int[n];     // parent[i] = parent in shortest path
@@ -101,30 +152,40 @@ Graph Algorithms::dijkstra(int start) {
     PriorityQueue pq(n);            // Priority queue for vertices
     dist[start] = 0;                // Distance to start vertex is 0
     pq.insert(start, 0);            // Insert start vertex into PQ
+    STAT_ADD(heapPushes, 1);
 
     while (!pq.isEmpty()) {         // While PQ is not empty
         PriorityQueue::Item item = pq.extractMin(); // Extract vertex u with minimum distance
+        STAT_ADD(heapPops, 1);
         int u = item.vertex;
-        if (inTree[u]) continue;
+        if (inTree[u]) {            // Duplicate entry of a settled vertex
+            STAT_ADD(stalePops, 1);
+            continue;
+        }
         inTree[u] = true;
+        STAT_ADD(verticesVisited, 1);
 
         // If u is not the start node, add edge (parent[u], u) to the tree
         if (parent[u] != -1) {
-            for (int i = 0; i < g.getSize(parent[u]); i++) {
-                if (g.getAdjList(parent[u])[i] == u) {
-                    tree.addEdge(parent[u], u, g.getWeights(parent[u])[i]);
+            for (Edge e : g.edges(parent[u])) {
+                STAT_ADD(edgesScanned, 1);
+                if (e.dst == u) {
+                    tree.addEdge(parent[u], u, e.w);
                     break;
                 }
             }
         }
         // Relaxation step for neighbors of u
-        for (int i = 0; i < g.getSize(u); i++) {
-            int v = g.getAdjList(u)[i];
-            int weight = g.getWeights(u)[i];
+        for (Edge e : g.edges(u)) {
+            STAT_ADD(edgesScanned, 1);
+            int v = e.dst;
+            int weight = e.w;
             if (!inTree[v] && dist[u] + weight < dist[v]) {
                 dist[v] = dist[u] + weight;
                 parent[v] = u;
                 pq.insert(v, dist[v]);
+                STAT_ADD(relaxations, 1);
+                STAT_ADD(heapPushes, 1);
             }
         }
     }
@@ -132,12 +193,222 @@ Graph Algorithms::dijkstra(int start) {
     delete[] dist;
     delete[] parent;
     delete[] inTree;
+    if (stats != nullptr) *stats = counters;
     return tree;                    // Return shortest path tree
 }
 
+// Multi-source Dijkstra over groups of searches.
+// Labels are stored vertex-major (the labels of v for all searches of a group are adjacent)
+// and every vertex has a bit mask of the searches whose label improved since v was last
+// scanned. One heap orders the vertices by their smallest pending label, and popping a
+// vertex scans its adjacency list once for all of its pending searches. A label may be
+// scanned before it is final for its own search; it is then improved and scanned again,
+// so the result equals k separate Dijkstra runs.
+// Sharing only pays off when the searches reach vertices together (small-world graphs).
+// The first group is a small probe: if its scans served few searches each (grids, road
+// networks), the remaining sources run one at a time instead of in wide groups.
+template <class GraphT>
+void BasicAlgorithms<GraphT>::dijkstraBatch(const int* sources, int k, int* dist, AlgorithmStats* stats) const {
+    PerfScope perf("dijkstraBatch", g.getNumVertices(), perfEdgeCount(g));
+    int n = g.getNumVertices();
+    if (k < 0) {
+        throw "Invalid number of sources!";
+    }
+    for (int q = 0; q < k; q++) {
+        if (sources[q] < 0 || sources[q] >= n) {
+            throw "Invalid starting vertex!";
+        }
+    }
+    for (int u = 0; u < n; u++) {
+        for (Edge e : g.edges(u)) {
+            if (e.w < 0) {
+                throw "Dijkstra's algorithm does'nt support negative weights!";
+            }
+        }
+    }
+
+    AlgorithmStats counters;        // Operation counts (only updated with GRAPH_ENABLE_STATS)
+    const int MAX_GROUP = 64;       // Bits of the pending mask
+    const int PROBE_GROUP = 8;
+    const int INF = DIST_INF;       // Also the output value of unreachable vertices
+    int maxWidth = k < MAX_GROUP ? k : MAX_GROUP;
+    int* label = new int[(long long)n * (maxWidth > 0 ? maxWidth : 1)];    // label[v * w + q]
+    unsigned long long* pending = new unsigned long long[n > 0 ? n : 1](); // Searches to relax from v
+    IndexedHeap heap(n);
+
+    int groupWidth = PROBE_GROUP;
+    for (int first = 0; first < k;) {
+        int w = k - first < groupWidth ? k - first : groupWidth;
+        long long scans = 0, lanes = 0;     // Vertex scans and the searches they served
+        for (long long i = 0; i < (long long)n * w; i++) {
+            label[i] = INF;
+        }
+        for (int q = 0; q < w; q++) {
+            int s = sources[first + q];
+            label[(long long)s * w + q] = 0;
+            pending[s] |= 1ULL << q;
+            heap.pushOrDecrease(s, 0);
+            STAT_ADD(heapPushes, 1);
+        }
+        while (!heap.isEmpty()) {
+            int u = heap.popMin().vertex;
+            STAT_ADD(heapPops, 1);
+            STAT_ADD(verticesVisited, 1);
+            unsigned long long bits = pending[u];
+            pending[u] = 0;
+            scans++;
+            lanes += __builtin_popcountll(bits);
+            const int* from = label + (long long)u * w;
+            for (Edge e : g.edges(u)) {
+                STAT_ADD(edgesScanned, 1);
+                int* to = label + (long long)e.dst * w;
+                unsigned long long improved = 0;
+                long long key = INF;
+                for (unsigned long long rest = bits; rest != 0; rest &= rest - 1) {
+                    int q = __builtin_ctzll(rest);
+                    long long candidate = (long long)from[q] + e.w;
+                    if (candidate < to[q]) {
+                        to[q] = (int)candidate;
+                        improved |= rest & (~rest + 1);     // Lowest set bit
+                        if (candidate < key) key = candidate;
+                        STAT_ADD(relaxations, 1);
+                    }
+                }
+                if (improved != 0) {
+                    pending[e.dst] |= improved;
+                    heap.pushOrDecrease(e.dst, (int)key);
+                    STAT_ADD(heapPushes, 1);
+                }
+            }
+        }
+        for (int q = 0; q < w; q++) {   // Back to one row per search
+            int* row = dist + (long long)(first + q) * n;
+            for (int v = 0; v < n; v++) {
+                row[v] = label[(long long)v * w + q];
+            }
+        }
+        if (first == 0) {               // Probe done: at least 1.5 searches per scan to keep grouping
+            groupWidth = 2 * lanes >= 3 * scans ? MAX_GROUP : 1;
+        }
+        first += w;
+    }
+    delete[] label;
+    delete[] pending;
+    if (stats != nullptr) *stats = counters;
+}
+
+// SPFA from the vertices already in q (their dist set). Returns false on a negative cycle.
+// SLF (small label first): a vertex whose new label is below the label at the front of the
+// queue goes to the front. LLL (large label last): before a pop, front vertices with a
+// label above the queue average are moved to the back.
+// A shortest path has at most n - 1 arcs, so a label whose path reaches n arcs proves a
+// negative cycle (checked on the path length instead of on enqueue counts).
+template <class GraphT>
+static bool spfa(const GraphT& g, Queue& q, int* dist, int* parent, AlgorithmStats& counters) {
+    (void)counters;                 // Unused without GRAPH_ENABLE_STATS
+    int n = g.getNumVertices();
+    int* hops = new int[n > 0 ? n : 1]();   // Arcs on the current path to v
+    bool* inQueue = new bool[n > 0 ? n : 1]();
+    long long sum = 0;                      // Sum of the labels in the queue (for LLL)
+    for (int i = 0; i < q.getSize(); i++) { // Seeds: rotate through once
+        int v = q.dequeue();
+        inQueue[v] = true;
+        sum += dist[v];
+        q.enqueue(v);
+    }
+    bool negativeCycle = false;
+    while (!q.isEmpty() && !negativeCycle) {
+        int queued = q.getSize();
+        for (int i = 0; i < queued && (long long)dist[q.peek()] * queued > sum; i++) {
+            q.enqueue(q.dequeue());         // LLL: above average, retry later
+        }
+        int u = q.dequeue();
+        inQueue[u] = false;
+        sum -= dist[u];
+        STAT_ADD(verticesVisited, 1);
+        for (Edge e : g.edges(u)) {
+            STAT_ADD(edgesScanned, 1);
+            int v = e.dst;
+            long long candidate = (long long)dist[u] + e.w;
+            if (candidate >= dist[v]) continue;
+            if (candidate <= -(long long)DIST_INF) {
+                negativeCycle = true;       // Only reachable through a negative cycle
+                break;
+            }
+            STAT_ADD(relaxations, 1);
+            if (inQueue[v]) {
+                sum += candidate - dist[v];
+            } else {
+                if (!q.isEmpty() && candidate < dist[q.peek()]) q.pushFront(v); // SLF
+                else q.enqueue(v);
+                inQueue[v] = true;
+                sum += candidate;
+            }
+            dist[v] = (int)candidate;
+            if (parent != nullptr) parent[v] = u;
+            hops[v] = hops[u] + 1;
+            if (hops[v] >= n) {
+                negativeCycle = true;
+                break;
+            }
+        }
+    }
+    delete[] hops;
+    delete[] inQueue;
+    return !negativeCycle;
+}
+
+template <class GraphT>
+int BasicAlgorithms<GraphT>::bellmanFord(int start, int* dist, int* parent, AlgorithmStats* stats) const {
+    PerfScope perf("bellmanFord", g.getNumVertices(), perfEdgeCount(g));
+    int n = g.getNumVertices();
+    if (start < 0 || start >= n) {
+        throw "Invalid starting vertex!";
+    }
+    AlgorithmStats counters;        // Operation counts (only updated with GRAPH_ENABLE_STATS)
+    for (int v = 0; v < n; v++) {
+        dist[v] = DIST_INF;
+        if (parent != nullptr) parent[v] = -1;
+    }
+    Queue q(n);
+    dist[start] = 0;
+    q.enqueue(start);
+    bool ok = spfa(g, q, dist, parent, counters);
+    if (stats != nullptr) *stats = counters;
+    if (!ok) {
+        throw "Graph contains a negative cycle!";
+    }
+    int reached = 0;
+    for (int v = 0; v < n; v++) {
+        if (dist[v] != DIST_INF) reached++;
+    }
+    return reached;
+}
+
+template <class GraphT>
+void BasicAlgorithms<GraphT>::johnsonPotentials(int* h, AlgorithmStats* stats) const {
+    PerfScope perf("johnsonPotentials", g.getNumVertices(), perfEdgeCount(g));
+    int n = g.getNumVertices();
+    AlgorithmStats counters;        // Operation counts (only updated with GRAPH_ENABLE_STATS)
+    Queue q(n > 0 ? n : 1);
+    for (int v = 0; v < n; v++) {   // The virtual source reaches every vertex at distance 0
+        h[v] = 0;
+        q.enqueue(v);
+    }
+    bool ok = spfa(g, q, h, nullptr, counters);
+    if (stats != nullptr) *stats = counters;
+    if (!ok) {
+        throw "Graph contains a negative cycle!";
+    }
+}
+
 // Prim's algorithm for Minimum Spanning Tree (MST)
-Graph Algorithms::prim() {
+template <class GraphT>
+Graph BasicAlgorithms<GraphT>::prim(AlgorithmStats* stats) const {
+    PerfScope perf("prim", g.getNumVertices(), perfEdgeCount(g));
     int n = g.getNumVertices();
+    AlgorithmStats counters;        // Operation counts (only updated with GRAPH_ENABLE_STATS)
+    if (stats != nullptr) *stats = counters;
     if (n == 0) {                   // Handle empty graph
         return Graph(0);
     }
@@ -168,14 +439,17 @@ Graph Algorithms::prim() {
 
         if (u == -1) break;         // Stop if graph is disconnected
         inMST[u] = true;
+        STAT_ADD(verticesVisited, 1);
 
         // Update key and parent for neighbors of u
-        for (int i = 0; i < g.getSize(u); i++) {
-            int v = g.getAdjList(u)[i];
-            int weight = g.getWeights(u)[i];
+        for (Edge e : g.edges(u)) {
+            STAT_ADD(edgesScanned, 1);
+            int v = e.dst;
+            int weight = e.w;
             if (!inMST[v] && weight < key[v]) {
                 key[v] = weight;
                 parent[v] = u;
+                STAT_ADD(relaxations, 1);
             }
         }
     }
@@ -191,13 +465,18 @@ Graph Algorithms::prim() {
     delete[] inMST;
     delete[] key;
     delete[] parent;
+    if (stats != nullptr) *stats = counters;
 
     return mst;
 }
 
 // Kruskal's algorithm for Minimum Spanning Tree (MST)
-Graph Algorithms::kruskal() {
+template <class GraphT>
+Graph BasicAlgorithms<GraphT>::kruskal(AlgorithmStats* stats) const {
+    PerfScope perf("kruskal", g.getNumVertices(), perfEdgeCount(g));
     int n = g.getNumVertices();
+    AlgorithmStats counters;        // Operation counts (only updated with GRAPH_ENABLE_STATS)
+    if (stats != nullptr) *stats = counters;
     if (n == 0) {                   // Handle empty graph
         return Graph(0);
     }
@@ -211,11 +490,12 @@ Graph Algorithms::kruskal() {
     Edge* edges = new Edge[n * n]; // Potential over-allocation
     int edgeCount = 0;
     for (int u = 0; u < n; u++) {
-        for (int i = 0; i < g.getSize(u); i++) {
-            int v = g.getAdjList(u)[i];
+        for (graph::Edge e : g.edges(u)) {
+            STAT_ADD(edgesScanned, 1);
+            int v = e.dst;
             // Avoid duplicate edges for undirected graph
             if (u < v) {
-                edges[edgeCount] = {u, v, g.getWeights(u)[i]};
+                edges[edgeCount] = {u, v, e.w};
                 edgeCount++;
             }
         }
@@ -246,12 +526,18 @@ Graph Algorithms::kruskal() {
             throw "Invalid vertex in find!";
         }
 
+        long long path = 0;         // Parent links followed
         while (u != parent[u]) {
             u = parent[u];
+            path++;
             if (u < 0 || u >= n) { // Basic safety check
                 throw "Invalid parent in find!";
             }
         }
+        STAT_ADD(finds, 1);
+        STAT_ADD(findPathLength, path);
+        STAT_MAX(maxFindPath, path);
+        (void)path;
         return u;
     };
 
@@ -260,6 +546,7 @@ Graph Algorithms::kruskal() {
         int rootU = find(u);
         int rootV = find(v);
         parent[rootU] = rootV; // Naive union
+        STAT_ADD(unions, 1);
     };
 
     int edgesAdded = 0;
@@ -271,12 +558,14 @@ Graph Algorithms::kruskal() {
             unionSets(u, v);
             mst.addEdge(u, v, edges[i].weight);
             edgesAdded++;
+            STAT_ADD(verticesVisited, 1);
         }
     }
 
     // Free memory
     delete[] edges;
     delete[] parent;
+    if (stats != nullptr) *stats = counters;
 
     // Check if MST was formed (graph connected)
 
@@ -287,4 +576,43 @@ Graph Algorithms::kruskal() {
     return mst;
 }
 
+// Label connected components with BFS sweeps
+template <class GraphT>
+int BasicAlgorithms<GraphT>::connectedComponents(int* component, AlgorithmStats* stats) const {
+    PerfScope perf("connectedComponents", g.getNumVertices(), perfEdgeCount(g));
+    int n = g.getNumVertices();
+    for (int v = 0; v < n; v++) {
+        component[v] = -1;          // Not reached yet
+    }
+    AlgorithmStats counters;        // Operation counts (only updated with GRAPH_ENABLE_STATS)
+    Queue q(n > 0 ? n : 1);
+    int count = 0;
+    for (int s = 0; s < n; s++) {
+        if (component[s] != -1) continue;
+        component[s] = count;       // New component rooted at s
+        q.enqueue(s);
+        while (!q.isEmpty()) {
+            int u = q.dequeue();
+            STAT_ADD(verticesVisited, 1);
+            for (Edge e : g.edges(u)) {
+                STAT_ADD(edgesScanned, 1);
+                if (component[e.dst] == -1) {
+                    component[e.dst] = count;
+                    q.enqueue(e.dst);
+                }
+            }
+        }
+        count++;
+    }
+    if (stats != nullptr) *stats = counters;
+    return count;
+}
+
+// Explicit instantiations for the supported graph storages
+template class BasicAlgorithms<Graph>;
+template class BasicAlgorithms<UnweightedGraph>;
+template class BasicAlgorithms<InterleavedGraph>;
+template class BasicAlgorithms<CSRGraph>;
+template class BasicAlgorithms<CompressedGraph>;
+
 } // namespace graph
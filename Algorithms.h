@@ -7,21 +7,67 @@
 
 namespace graph {
 
-class Algorithms {
+// Operation counts of one algorithm call, filled when the library is built with
+// GRAPH_ENABLE_STATS (make STATS=1). Without it the counting code is compiled out and the
+// struct is only reset to zeros.
+struct AlgorithmStats {
+    long long verticesVisited = 0;  // Vertices dequeued / settled / added to the tree
+    long long edgesScanned = 0;     // Adjacency entries read
+    long long relaxations = 0;      // Successful distance / key improvements
+    long long heapPushes = 0;       // Priority queue inserts
+    long long heapPops = 0;         // Priority queue extractions
+    long long stalePops = 0;        // Extractions of already settled vertices (duplicates)
+    long long finds = 0;            // Union-find find calls
+    long long unions = 0;           // Union-find union calls
+    long long findPathLength = 0;   // Parent links followed by all finds
+    long long maxFindPath = 0;      // Longest single find path
+};
+
+bool algorithmStatsEnabled();       // Library built with GRAPH_ENABLE_STATS
+
+// Distance of unreachable vertices in every shortest path result (distances may be negative)
+const int DIST_INF = 0x7fffffff;
+
+// Algorithms over any graph storage (result trees are always weighted Graphs).
+// The graph is only read and the methods keep no state between calls, so one graph (and
+// one BasicAlgorithms object) can serve concurrent queries from several threads as long
+// as nobody modifies or copies the graph meanwhile.
+template <class GraphT>
+class BasicAlgorithms {
 private:
-    Graph& g;
-    void dfsUtil(int u, bool* visited, Graph& tree);
+    const GraphT& g;
+    void dfsUtil(int u, bool* visited, Graph& tree, AlgorithmStats& counters) const;
 
 public:
-    Algorithms(Graph& graph); 
+    BasicAlgorithms(const GraphT& graph);
 
-    Graph bfs(int source); 
-    Graph dfs(int source); 
-    Graph dijkstra(int start);
-    Graph prim(); 
-    Graph kruskal(); 
+    // stats (optional) receives the operation counts of the call
+    Graph bfs(int source, AlgorithmStats* stats = nullptr) const;
+    Graph dfs(int source, AlgorithmStats* stats = nullptr) const;
+    Graph dijkstra(int start, AlgorithmStats* stats = nullptr) const;
+    // Shortest path distances from k sources at once: dist is a k x n matrix (row q holds
+    // the distances from sources[q], DIST_INF for unreachable vertices). Up to 64 searches share
+    // one frontier, so every adjacency list scan serves all the searches that reached the vertex.
+    void dijkstraBatch(const int* sources, int k, int* dist, AlgorithmStats* stats = nullptr) const;
+    // Shortest paths with negative weights: SPFA (queue-based Bellman-Ford) with the SLF and
+    // LLL queue heuristics. dist receives n distances (DIST_INF for unreachable vertices),
+    // parent (optional) the shortest path tree. Throws if a negative cycle is reachable from
+    // start. In an undirected graph a negative edge is itself a negative cycle, so negative
+    // weights need a directed CSRGraph (GraphBuilder::buildCSR(false)).
+    // Returns the number of reached vertices.
+    int bellmanFord(int start, int* dist, int* parent = nullptr, AlgorithmStats* stats = nullptr) const;
+    // Johnson potentials: h[v] = distance to v from a virtual source with a zero-weight arc
+    // to every vertex. Then w(u, v) + h[u] - h[v] >= 0 for every arc, so Dijkstra works on
+    // the reweighted graph. Throws if the graph has a negative cycle.
+    void johnsonPotentials(int* h, AlgorithmStats* stats = nullptr) const;
+    Graph prim(AlgorithmStats* stats = nullptr) const;
+    Graph kruskal(AlgorithmStats* stats = nullptr) const;
+    // component[v] = id in [0, count), returns count
+    int connectedComponents(int* component, AlgorithmStats* stats = nullptr) const;
 };
 
-} 
+using Algorithms = BasicAlgorithms<Graph>;
+
+}
 
 #endif
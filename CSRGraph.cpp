@@ -0,0 +1,253 @@
+// michael9090124@gmail.com
+
+#include "CSRGraph.h"
+#include <cstdio>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace graph {
+
+static const long long EMPTY_OFFSETS[1] = {0}; // Offsets of a graph with no vertices
+
+// Round a byte position up to the section alignment
+static unsigned long long alignUp(unsigned long long pos) {
+    return (pos + GRAPH_FILE_ALIGN - 1) / GRAPH_FILE_ALIGN * GRAPH_FILE_ALIGN;
+}
+
+CSRGraph::CSRGraph()
+    : numVertices(0), numEdges(0), flags(GRAPH_FILE_SYMMETRIC), offsets(EMPTY_OFFSETS),
+      neighbors(nullptr), weights(nullptr), ownedOffsets(nullptr), ownedNeighbors(nullptr),
+      ownedWeights(nullptr), mapping(nullptr), mappingSize(0) {}
+
+CSRGraph::CSRGraph(int vertices, long long edges, long long* offsetArray, int* neighborArray,
+                   int* weightArray, bool symmetric)
+    : numVertices(vertices), numEdges(edges), flags(0), offsets(offsetArray),
+      neighbors(neighborArray), weights(weightArray), ownedOffsets(offsetArray),
+      ownedNeighbors(neighborArray), ownedWeights(weightArray), mapping(nullptr), mappingSize(0) {
+    if (vertices < 0 || edges < 0) {
+        throw "Invalid CSR graph size!";
+    }
+    if (weightArray != nullptr) flags |= GRAPH_FILE_WEIGHTED;
+    if (symmetric) flags |= GRAPH_FILE_SYMMETRIC;
+}
+
+CSRGraph::CSRGraph(CSRGraph&& other) noexcept
+    : numVertices(other.numVertices), numEdges(other.numEdges), flags(other.flags),
+      offsets(other.offsets), neighbors(other.neighbors), weights(other.weights),
+      ownedOffsets(other.ownedOffsets), ownedNeighbors(other.ownedNeighbors),
+      ownedWeights(other.ownedWeights), mapping(other.mapping), mappingSize(other.mappingSize) {
+    // Leave other as a valid empty graph
+    other.numVertices = 0;
+    other.numEdges = 0;
+    other.offsets = EMPTY_OFFSETS;
+    other.neighbors = nullptr;
+    other.weights = nullptr;
+    other.ownedOffsets = nullptr;
+    other.ownedNeighbors = nullptr;
+    other.ownedWeights = nullptr;
+    other.mapping = nullptr;
+    other.mappingSize = 0;
+}
+
+CSRGraph& CSRGraph::operator=(CSRGraph&& other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+    release();
+    numVertices = other.numVertices;
+    numEdges = other.numEdges;
+    flags = other.flags;
+    offsets = other.offsets;
+    neighbors = other.neighbors;
+    weights = other.weights;
+    ownedOffsets = other.ownedOffsets;
+    ownedNeighbors = other.ownedNeighbors;
+    ownedWeights = other.ownedWeights;
+    mapping = other.mapping;
+    mappingSize = other.mappingSize;
+    other.numVertices = 0;
+    other.numEdges = 0;
+    other.offsets = EMPTY_OFFSETS;
+    other.neighbors = nullptr;
+    other.weights = nullptr;
+    other.ownedOffsets = nullptr;
+    other.ownedNeighbors = nullptr;
+    other.ownedWeights = nullptr;
+    other.mapping = nullptr;
+    other.mappingSize = 0;
+    return *this;
+}
+
+CSRGraph::~CSRGraph() {
+    release();
+}
+
+// Free owned arrays or unmap the file
+void CSRGraph::release() {
+    delete[] ownedOffsets;
+    delete[] ownedNeighbors;
+    delete[] ownedWeights;
+#ifndef _WIN32
+    if (mapping != nullptr) {
+        munmap(mapping, mappingSize);
+    }
+#endif
+    ownedOffsets = nullptr;
+    ownedNeighbors = nullptr;
+    ownedWeights = nullptr;
+    mapping = nullptr;
+    mappingSize = 0;
+}
+
+int CSRGraph::getSize(int v) const { // Number of neighbors for vertex v
+    if (v < 0 || v >= numVertices) {
+        throw "Invalid vertex!";
+    }
+    return (int)(offsets[v + 1] - offsets[v]);
+}
+
+template <class WeightPolicy>
+CSRGraph CSRGraph::fromGraph(const BasicGraph<WeightPolicy>& g) {
+    int n = g.getNumVertices();
+    long long* offs = new long long[n + 1];
+    offs[0] = 0;
+    for (int v = 0; v < n; v++) {
+        offs[v + 1] = offs[v] + g.getSize(v);
+    }
+    long long m = offs[n];
+    int* nbrs = new int[m];
+    int* wts = WeightPolicy::hasWeights ? new int[m] : nullptr;
+    for (int v = 0; v < n; v++) {
+        long long pos = offs[v];
+        for (Edge e : g.edges(v)) {
+            nbrs[pos] = e.dst;
+            if (wts != nullptr) wts[pos] = e.w;
+            pos++;
+        }
+    }
+    return CSRGraph(n, m, offs, nbrs, wts, true); // Graph edges are always undirected
+}
+
+void CSRGraph::writeFile(const char* path) const {
+    GraphFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, GRAPH_FILE_MAGIC, sizeof(header.magic));
+    header.version = GRAPH_FILE_VERSION;
+    header.flags = flags;
+    header.numVertices = (unsigned long long)numVertices;
+    header.numEdges = (unsigned long long)numEdges;
+    header.offsetsPos = alignUp(sizeof(GraphFileHeader));
+    header.neighborsPos = alignUp(header.offsetsPos + (header.numVertices + 1) * sizeof(long long));
+    unsigned long long end = header.neighborsPos + header.numEdges * sizeof(int);
+    if (weights != nullptr) {
+        header.weightsPos = alignUp(end);
+        end = header.weightsPos + header.numEdges * sizeof(int);
+    }
+    header.fileSize = end;
+
+    FILE* file = std::fopen(path, "wb");
+    if (file == nullptr) {
+        throw "Cannot open graph file for writing!";
+    }
+    // Write a section at its aligned position, zero-filling the gap before it
+    unsigned long long written = 0;
+    static const char zeros[GRAPH_FILE_ALIGN] = {0};
+    auto writeAt = [&](unsigned long long pos, const void* data, unsigned long long bytes) -> bool {
+        if (pos > written && std::fwrite(zeros, 1, pos - written, file) != pos - written) return false;
+        if (bytes > 0 && std::fwrite(data, 1, bytes, file) != bytes) return false;
+        written = pos + bytes;
+        return true;
+    };
+    bool ok = writeAt(0, &header, sizeof(header))
+           && writeAt(header.offsetsPos, offsets, (header.numVertices + 1) * sizeof(long long))
+           && writeAt(header.neighborsPos, neighbors, header.numEdges * sizeof(int));
+    if (ok && weights != nullptr) {
+        ok = writeAt(header.weightsPos, weights, header.numEdges * sizeof(int));
+    }
+    if (std::fclose(file) != 0) ok = false;
+    if (!ok) {
+        throw "Failed to write graph file!";
+    }
+}
+
+// Section [pos, pos + bytes) lies after the header and inside the file, without overflow
+// (bytes itself can't wrap: numVertices and numEdges are bounded before this is called)
+static bool sectionFits(unsigned long long pos, unsigned long long bytes, unsigned long long size) {
+    return pos >= sizeof(GraphFileHeader) && pos <= size && bytes <= size - pos;
+}
+
+CSRGraph CSRGraph::mapFile(const char* path) {
+#ifdef _WIN32
+    (void)path;
+    throw "Memory-mapped graph files are not supported on this platform!";
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        throw "Cannot open graph file!";
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (unsigned long long)st.st_size < sizeof(GraphFileHeader)) {
+        close(fd);
+        throw "Graph file is too small!";
+    }
+    unsigned long long size = (unsigned long long)st.st_size;
+    void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping stays valid after closing the descriptor
+    if (map == MAP_FAILED) {
+        throw "Cannot map graph file!";
+    }
+
+    // Validate the header only: section contents are served as-is (zero parsing)
+    const char* base = static_cast<const char*>(map);
+    const GraphFileHeader* h = reinterpret_cast<const GraphFileHeader*>(base);
+    const char* error = nullptr;
+    bool weighted = (h->flags & GRAPH_FILE_WEIGHTED) != 0;
+    if (std::memcmp(h->magic, GRAPH_FILE_MAGIC, sizeof(h->magic)) != 0) {
+        error = "Not a binary graph file!";
+    } else if (h->version != GRAPH_FILE_VERSION) {
+        error = "Unsupported graph file version!";
+    } else if (h->fileSize != size || h->numVertices > 0x7fffffffULL || h->numEdges > (size / sizeof(int))) {
+        error = "Corrupt graph file header!";
+    } else if (h->offsetsPos % GRAPH_FILE_ALIGN != 0 || h->neighborsPos % GRAPH_FILE_ALIGN != 0
+               || (weighted && h->weightsPos % GRAPH_FILE_ALIGN != 0)) {
+        error = "Misaligned graph file section!";
+    } else if (!sectionFits(h->offsetsPos, (h->numVertices + 1) * sizeof(long long), size)
+               || !sectionFits(h->neighborsPos, h->numEdges * sizeof(int), size)
+               || (weighted && !sectionFits(h->weightsPos, h->numEdges * sizeof(int), size))) {
+        error = "Graph file section out of bounds!";
+    } else {
+        const long long* offs = reinterpret_cast<const long long*>(base + h->offsetsPos);
+        if (offs[0] != 0 || offs[h->numVertices] != (long long)h->numEdges) {
+            error = "Corrupt graph file offsets!";
+        }
+    }
+    if (error != nullptr) {
+        munmap(map, size);
+        throw error;
+    }
+
+    CSRGraph g;
+    g.numVertices = (int)h->numVertices;
+    g.numEdges = (long long)h->numEdges;
+    g.flags = h->flags;
+    g.offsets = reinterpret_cast<const long long*>(base + h->offsetsPos);
+    g.neighbors = reinterpret_cast<const int*>(base + h->neighborsPos);
+    g.weights = weighted ? reinterpret_cast<const int*>(base + h->weightsPos) : nullptr;
+    g.mapping = map;
+    g.mappingSize = size;
+    return g;
+#endif
+}
+
+// Explicit instantiations for the supported storage policies
+template CSRGraph CSRGraph::fromGraph<Weighted>(const BasicGraph<Weighted>& g);
+template CSRGraph CSRGraph::fromGraph<Unweighted>(const BasicGraph<Unweighted>& g);
+template CSRGraph CSRGraph::fromGraph<Interleaved>(const BasicGraph<Interleaved>& g);
+
+} // namespace graph
@@ -0,0 +1,129 @@
+// michael9090124@gmail.com
+
+#ifndef CSR_GRAPH_H
+#define CSR_GRAPH_H
+
+#include "Graph.h"
+
+namespace graph {
+
+// Binary graph file layout (version 1, little-endian, every section 64-byte aligned):
+//   [GraphFileHeader]
+//   [offsets:   int64 x (numVertices + 1)]   edges of v are [offsets[v], offsets[v+1])
+//   [neighbors: int32 x numEdges]
+//   [weights:   int32 x numEdges]            only if GRAPH_FILE_WEIGHTED is set
+// numEdges counts directed arcs: an undirected edge is stored once in each direction.
+const char GRAPH_FILE_MAGIC[8] = {'G', 'R', 'A', 'P', 'H', 'C', 'S', 'R'};
+const unsigned int GRAPH_FILE_VERSION = 1;
+const unsigned int GRAPH_FILE_WEIGHTED = 1;     // Weights section present
+const unsigned int GRAPH_FILE_SYMMETRIC = 2;    // Every arc u->v has a matching v->u
+const int GRAPH_FILE_ALIGN = 64;
+
+struct GraphFileHeader {
+    char magic[8];
+    unsigned int version;
+    unsigned int flags;
+    unsigned long long numVertices;
+    unsigned long long numEdges;
+    unsigned long long offsetsPos;      // Byte position of each section in the file
+    unsigned long long neighborsPos;
+    unsigned long long weightsPos;      // 0 if the graph is unweighted
+    unsigned long long fileSize;
+};
+
+// Read-only compressed sparse row graph.
+// Either owns its arrays (snapshot of a Graph, result of a builder) or serves them
+// straight out of a memory-mapped file without parsing or copying.
+class CSRGraph {
+private:
+    int numVertices;
+    long long numEdges;
+    unsigned int flags;
+    const long long* offsets;
+    const int* neighbors;
+    const int* weights;         // nullptr when unweighted
+
+    // Ownership: heap arrays or a file mapping (at most one of the two)
+    long long* ownedOffsets;
+    int* ownedNeighbors;
+    int* ownedWeights;
+    void* mapping;
+    unsigned long long mappingSize;
+
+    void release();
+
+public:
+    CSRGraph();                 // Empty graph
+    // Takes ownership of arrays allocated with new[] (weights may be nullptr)
+    CSRGraph(int vertices, long long edges, long long* offsetArray, int* neighborArray,
+             int* weightArray, bool symmetric);
+    CSRGraph(CSRGraph&& other) noexcept;
+    CSRGraph& operator=(CSRGraph&& other) noexcept;
+    CSRGraph(const CSRGraph&) = delete;
+    CSRGraph& operator=(const CSRGraph&) = delete;
+    ~CSRGraph();
+
+    // Snapshot of an adjacency-list graph (neighbor order is preserved)
+    template <class WeightPolicy>
+    static CSRGraph fromGraph(const BasicGraph<WeightPolicy>& g);
+
+    // Map a binary graph file read-only; throws on a malformed header
+    static CSRGraph mapFile(const char* path);
+    // Write this graph in the binary format
+    void writeFile(const char* path) const;
+
+    int getNumVertices() const { return numVertices; }
+    long long getNumEdges() const { return numEdges; }
+    bool isWeighted() const { return weights != nullptr; }
+    bool isSymmetric() const { return (flags & GRAPH_FILE_SYMMETRIC) != 0; }
+    bool isMapped() const { return mapping != nullptr; }
+    int getSize(int v) const;
+    const long long* getOffsets() const { return offsets; }
+    const int* getNeighbors() const { return neighbors; }
+    const int* getWeights() const { return weights; }
+
+    // Unchecked accessors, same interface as BasicGraph
+    int neighborAt(int v, int i) const { return neighbors[offsets[v] + i]; }
+    int weightAt(int v, int i) const { return weights ? weights[offsets[v] + i] : 1; }
+
+    class EdgeIterator {
+    private:
+        const int* nbr;
+        const int* wt;      // nullptr for unweighted graphs
+    public:
+        EdgeIterator(const int* n, const int* w) : nbr(n), wt(w) {}
+        Edge operator*() const {
+            Edge e;
+            e.dst = *nbr;
+            e.w = wt ? *wt : 1;
+            return e;
+        }
+        EdgeIterator& operator++() {
+            nbr++;
+            if (wt) wt++;
+            return *this;
+        }
+        bool operator!=(const EdgeIterator& other) const { return nbr != other.nbr; }
+    };
+
+    class EdgeRange {
+    private:
+        EdgeIterator first;
+        EdgeIterator last;
+    public:
+        EdgeRange(EdgeIterator f, EdgeIterator l) : first(f), last(l) {}
+        EdgeIterator begin() const { return first; }
+        EdgeIterator end() const { return last; }
+    };
+
+    EdgeRange edges(int v) const { // Unchecked, v must be a valid vertex
+        long long b = offsets[v];
+        long long e = offsets[v + 1];
+        return EdgeRange(EdgeIterator(neighbors + b, weights ? weights + b : nullptr),
+                         EdgeIterator(neighbors + e, nullptr));
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,156 @@
+// michael9090124@gmail.com
+
+#include "CompressedGraph.h"
+
+namespace graph {
+
+static inline unsigned int zigzag(int x) {
+    return ((unsigned int)x << 1) ^ (unsigned int)(x >> 31);
+}
+
+static inline int varintSize(unsigned int x) {
+    int size = 1;
+    while (x >= 0x80) {
+        x >>= 7;
+        size++;
+    }
+    return size;
+}
+
+static inline unsigned char* writeVarint(unsigned char* p, unsigned int x) {
+    while (x >= 0x80) {
+        *p++ = (unsigned char)(x | 0x80);
+        x >>= 7;
+    }
+    *p++ = (unsigned char)x;
+    return p;
+}
+
+// In-place heap sort of edges by destination (for unsorted input lists)
+static void sortByDestination(Edge* edges, int n) {
+    auto siftDown = [&](int root, int size) {
+        while (2 * root + 1 < size) {
+            int child = 2 * root + 1;
+            if (child + 1 < size && edges[child + 1].dst > edges[child].dst) child++;
+            if (edges[root].dst >= edges[child].dst) return;
+            Edge tmp = edges[root];
+            edges[root] = edges[child];
+            edges[child] = tmp;
+            root = child;
+        }
+    };
+    for (int i = n / 2 - 1; i >= 0; i--) siftDown(i, n);
+    for (int end = n - 1; end > 0; end--) {
+        Edge tmp = edges[0];
+        edges[0] = edges[end];
+        edges[end] = tmp;
+        siftDown(0, end);
+    }
+}
+
+CompressedGraph::CompressedGraph()
+    : numVertices(0), numEdges(0), weighted(false), offsets(new long long[1]), bytes(nullptr) {
+    offsets[0] = 0;
+}
+
+CompressedGraph::CompressedGraph(const CSRGraph& csr)
+    : numVertices(csr.getNumVertices()), numEdges(csr.getNumEdges()), weighted(csr.isWeighted()) {
+    int n = numVertices;
+    offsets = new long long[n + 1];
+
+    // Largest degree, for the scratch buffer used to sort a list
+    int maxDegree = 0;
+    for (int v = 0; v < n; v++) {
+        if (csr.getSize(v) > maxDegree) maxDegree = csr.getSize(v);
+    }
+    Edge* scratch = new Edge[maxDegree > 0 ? maxDegree : 1];
+
+    // Copy (and sort if needed) the list of v into scratch
+    auto loadList = [&](int v) -> int {
+        int degree = 0;
+        bool sorted = true;
+        for (Edge e : csr.edges(v)) {
+            if (degree > 0 && e.dst < scratch[degree - 1].dst) sorted = false;
+            scratch[degree++] = e;
+        }
+        if (!sorted) sortByDestination(scratch, degree);
+        return degree;
+    };
+
+    // Pass 1: encoded size of every list
+    offsets[0] = 0;
+    for (int v = 0; v < n; v++) {
+        int degree = loadList(v);
+        long long size = varintSize((unsigned int)degree);
+        for (int i = 0; i < degree; i++) {
+            unsigned int gap = i == 0 ? zigzag(scratch[0].dst - v)
+                                      : (unsigned int)(scratch[i].dst - scratch[i - 1].dst);
+            size += varintSize(gap);
+            if (weighted) size += varintSize(zigzag(scratch[i].w));
+        }
+        offsets[v + 1] = offsets[v] + size;
+    }
+
+    // Pass 2: encode
+    bytes = new unsigned char[offsets[n] > 0 ? offsets[n] : 1];
+    for (int v = 0; v < n; v++) {
+        int degree = loadList(v);
+        unsigned char* p = bytes + offsets[v];
+        p = writeVarint(p, (unsigned int)degree);
+        for (int i = 0; i < degree; i++) {
+            unsigned int gap = i == 0 ? zigzag(scratch[0].dst - v)
+                                      : (unsigned int)(scratch[i].dst - scratch[i - 1].dst);
+            p = writeVarint(p, gap);
+            if (weighted) p = writeVarint(p, zigzag(scratch[i].w));
+        }
+    }
+    delete[] scratch;
+}
+
+CompressedGraph::CompressedGraph(CompressedGraph&& other) noexcept
+    : numVertices(other.numVertices), numEdges(other.numEdges), weighted(other.weighted),
+      offsets(other.offsets), bytes(other.bytes) {
+    // Leave other as a valid empty graph
+    other.numVertices = 0;
+    other.numEdges = 0;
+    other.offsets = nullptr;
+    other.bytes = nullptr;
+}
+
+CompressedGraph& CompressedGraph::operator=(CompressedGraph&& other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+    delete[] offsets;
+    delete[] bytes;
+    numVertices = other.numVertices;
+    numEdges = other.numEdges;
+    weighted = other.weighted;
+    offsets = other.offsets;
+    bytes = other.bytes;
+    other.numVertices = 0;
+    other.numEdges = 0;
+    other.offsets = nullptr;
+    other.bytes = nullptr;
+    return *this;
+}
+
+CompressedGraph::~CompressedGraph() {
+    delete[] offsets;
+    delete[] bytes;
+}
+
+int CompressedGraph::getSize(int v) const { // Number of neighbors for vertex v
+    if (v < 0 || v >= numVertices) {
+        throw "Invalid vertex!";
+    }
+    const unsigned char* p = bytes + offsets[v];
+    return (int)readVarint(p);
+}
+
+long long CompressedGraph::bytesUsed() const {
+    if (offsets == nullptr) return 0;
+    return offsets[numVertices] + (numVertices + 1) * (long long)sizeof(long long);
+}
+
+} // namespace graph
@@ -0,0 +1,97 @@
+// michael9090124@gmail.com
+
+#ifndef COMPRESSED_GRAPH_H
+#define COMPRESSED_GRAPH_H
+
+#include "CSRGraph.h"
+
+namespace graph {
+
+// Read-only graph with gap-encoded neighbor lists (WebGraph style).
+// Each vertex v owns a byte range holding:
+//   varint degree
+//   per edge: varint gap, then zigzag varint weight (weighted graphs only)
+// Neighbors are sorted; the first gap is zigzag(first - v), the others are neighbor - previous.
+// Lists can only be walked in order, through edges(v).
+class CompressedGraph {
+private:
+    int numVertices;
+    long long numEdges;
+    bool weighted;
+    long long* offsets;         // Byte offset of each vertex list, numVertices + 1 entries
+    unsigned char* bytes;
+
+public:
+    CompressedGraph();
+    explicit CompressedGraph(const CSRGraph& csr); // Sorts neighbor lists if needed
+    CompressedGraph(CompressedGraph&& other) noexcept;
+    CompressedGraph& operator=(CompressedGraph&& other) noexcept;
+    CompressedGraph(const CompressedGraph&) = delete;
+    CompressedGraph& operator=(const CompressedGraph&) = delete;
+    ~CompressedGraph();
+
+    int getNumVertices() const { return numVertices; }
+    long long getNumEdges() const { return numEdges; }
+    bool isWeighted() const { return weighted; }
+    int getSize(int v) const;
+    long long bytesUsed() const;    // Encoded lists plus offsets
+
+    static inline unsigned int readVarint(const unsigned char*& p) {
+        unsigned int value = *p & 0x7F;
+        int shift = 7;
+        while (*p++ & 0x80) {
+            value |= (unsigned int)(*p & 0x7F) << shift;
+            shift += 7;
+        }
+        return value;
+    }
+    static inline int unzigzag(unsigned int x) { return (int)(x >> 1) ^ -(int)(x & 1); }
+
+    class EdgeIterator {
+    private:
+        const unsigned char* p;     // Next encoded edge
+        int remaining;              // Edges not yet returned, including the current one
+        bool hasWeights;
+        Edge current;
+
+        void decode(bool first, int source) {
+            unsigned int gap = readVarint(p);
+            current.dst = first ? source + unzigzag(gap) : current.dst + (int)gap;
+            current.w = hasWeights ? unzigzag(readVarint(p)) : 1;
+        }
+
+    public:
+        EdgeIterator(const unsigned char* data, int count, bool w, int source)
+            : p(data), remaining(count), hasWeights(w) {
+            current.dst = 0;
+            current.w = 1;
+            if (remaining > 0) decode(true, source);
+        }
+        Edge operator*() const { return current; }
+        EdgeIterator& operator++() {
+            if (--remaining > 0) decode(false, 0);
+            return *this;
+        }
+        bool operator!=(const EdgeIterator& other) const { return remaining != other.remaining; }
+    };
+
+    class EdgeRange {
+    private:
+        EdgeIterator first;
+        EdgeIterator last;
+    public:
+        EdgeRange(EdgeIterator f, EdgeIterator l) : first(f), last(l) {}
+        EdgeIterator begin() const { return first; }
+        EdgeIterator end() const { return last; }
+    };
+
+    EdgeRange edges(int v) const { // Unchecked, v must be a valid vertex
+        const unsigned char* p = bytes + offsets[v];
+        int degree = (int)readVarint(p);
+        return EdgeRange(EdgeIterator(p, degree, weighted, v), EdgeIterator(nullptr, 0, weighted, v));
+    }
+};
+
+}
+
+#endif
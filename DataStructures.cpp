@@ -2,6 +2,8 @@
 
 #include "DataStructures.h"
 #include <iostream> // Keep include, remove comment
+#include <cstring>
+#include <climits>
 
 namespace graph {
 
@@ -19,24 +21,38 @@ Queue::~Queue() {
     delete[] array;         // Free array memory
 }
 
+void Queue::grow() {
+    int* newArray = new int[capacity * 2]; // Double the capacity
+    for (int i = 0; i < size; i++) {
+         // Copy to new array (handling wrap-around)
+        newArray[i] = array[(front + i) % capacity];
+    }
+    delete[] array;         // Free old array
+    array = newArray;       // Update pointer
+    front = 0;              // Reset front
+    rear = size - 1;        // Update rear
+    capacity *= 2;          // Update capacity
+}
+
 void Queue::enqueue(int x) {
     if (size == capacity) { // If queue is full
-        int* newArray = new int[capacity * 2]; // Double the capacity
-        for (int i = 0; i < size; i++) {
-             // Copy to new array (handling wrap-around)
-            newArray[i] = array[(front + i) % capacity];
-        }
-        delete[] array;         // Free old array
-        array = newArray;       // Update pointer
-        front = 0;              // Reset front
-        rear = size - 1;        // Update rear
-        capacity *= 2;          // Update capacity
+        grow();
     }
     rear = (rear + 1) % capacity; // Update rear circularly
     array[rear] = x;            // Add the element
     size++;                     // Increment size
 }
 
+void Queue::pushFront(int x) {
+    if (size == capacity) { // If queue is full
+        grow();
+    }
+    front = (front - 1 + capacity) % capacity; // Step front back circularly
+    array[front] = x;
+    if (size == 0) rear = front;
+    size++;
+}
+
 int Queue::dequeue() {
     if (isEmpty()) {
         throw "Queue is empty!"; // Translated exception
@@ -47,10 +63,152 @@ int Queue::dequeue() {
     return item;                // Return the removed item
 }
 
+int Queue::peek() const {
+    if (size == 0) {
+        throw "Queue is empty!";
+    }
+    return array[front];
+}
+
 bool Queue::isEmpty() {
     return size == 0;           // Returns true if the queue is empty
 }
 
+int Queue::getSize() const {
+    return size;
+}
+
+// --- MPMCQueue ---
+// Cell i starts with sequence i. A producer at position pos may write the cell when its
+// sequence equals pos and then publishes sequence pos + 1. A consumer at position pos may
+// read it when the sequence equals pos + 1 and then frees it for the next lap with
+// sequence pos + capacity.
+
+MPMCQueue::MPMCQueue(int cap) : head(0), tail(0) {
+    if (cap <= 0) {
+        throw "Queue capacity must be positive!";
+    }
+    unsigned long long size = 1;
+    while (size < (unsigned long long)cap) size <<= 1;  // Round up to a power of two
+    mask = size - 1;
+    cells = new Cell[size];
+    for (unsigned long long i = 0; i < size; i++) {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+MPMCQueue::~MPMCQueue() {
+    delete[] cells;
+}
+
+bool MPMCQueue::tryEnqueue(int x) {
+    unsigned long long pos = head.load(std::memory_order_relaxed);
+    while (true) {
+        Cell& cell = cells[pos & mask];
+        unsigned long long seq = cell.sequence.load(std::memory_order_acquire);
+        long long diff = (long long)(seq - pos);
+        if (diff == 0) {            // Free for this lap: claim the position
+            if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                cell.value = x;
+                cell.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {      // Still holds an item from the previous lap
+            return false;
+        } else {                    // Another producer got ahead, reload
+            pos = head.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool MPMCQueue::tryDequeue(int& x) {
+    unsigned long long pos = tail.load(std::memory_order_relaxed);
+    while (true) {
+        Cell& cell = cells[pos & mask];
+        unsigned long long seq = cell.sequence.load(std::memory_order_acquire);
+        long long diff = (long long)(seq - (pos + 1));
+        if (diff == 0) {            // Filled for this lap: claim the position
+            if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                x = cell.value;
+                cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {      // Not written yet: empty
+            return false;
+        } else {
+            pos = tail.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+// A run of ready cells starting at pos can only be changed by whoever owns those
+// positions, so after a successful CAS from pos the whole run belongs to this thread.
+int MPMCQueue::enqueueBatch(const int* items, int count) {
+    if (count <= 0) {
+        return 0;
+    }
+    unsigned long long pos = head.load(std::memory_order_relaxed);
+    while (true) {
+        int ready = 0;
+        while (ready < count &&
+               cells[(pos + ready) & mask].sequence.load(std::memory_order_acquire) == pos + ready) {
+            ready++;
+        }
+        if (ready == 0) {
+            long long diff = (long long)(cells[pos & mask].sequence.load(std::memory_order_acquire) - pos);
+            if (diff < 0) return 0; // Full
+            pos = head.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (head.compare_exchange_weak(pos, pos + ready, std::memory_order_relaxed)) {
+            for (int i = 0; i < ready; i++) {
+                Cell& cell = cells[(pos + i) & mask];
+                cell.value = items[i];
+                cell.sequence.store(pos + i + 1, std::memory_order_release);
+            }
+            return ready;
+        }
+    }
+}
+
+int MPMCQueue::dequeueBatch(int* items, int maxCount) {
+    if (maxCount <= 0) {
+        return 0;
+    }
+    unsigned long long pos = tail.load(std::memory_order_relaxed);
+    while (true) {
+        int ready = 0;
+        while (ready < maxCount &&
+               cells[(pos + ready) & mask].sequence.load(std::memory_order_acquire) == pos + ready + 1) {
+            ready++;
+        }
+        if (ready == 0) {
+            long long diff = (long long)(cells[pos & mask].sequence.load(std::memory_order_acquire) - (pos + 1));
+            if (diff < 0) return 0; // Empty
+            pos = tail.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (tail.compare_exchange_weak(pos, pos + ready, std::memory_order_relaxed)) {
+            for (int i = 0; i < ready; i++) {
+                Cell& cell = cells[(pos + i) & mask];
+                items[i] = cell.value;
+                cell.sequence.store(pos + i + mask + 1, std::memory_order_release);
+            }
+            return ready;
+        }
+    }
+}
+
+int MPMCQueue::capacity() const {
+    return (int)(mask + 1);
+}
+
+int MPMCQueue::sizeEstimate() const {
+    unsigned long long t = tail.load(std::memory_order_relaxed);
+    unsigned long long h = head.load(std::memory_order_relaxed);
+    return h > t ? (int)(h - t) : 0;
+}
+
 // --- PriorityQueue ---
 // Note: This is an inefficient implementation (O(N) extractMin).
 // A heap-based implementation is standard for efficiency.
@@ -100,6 +258,95 @@ bool PriorityQueue::isEmpty() {
     return size == 0;           // Returns true if the queue is empty
 }
 
+// --- IndexedHeap ---
+
+IndexedHeap::IndexedHeap(int n) {
+    capacity = n > 0 ? n : 1;
+    heap = new Item[capacity];
+    position = new int[capacity];
+    for (int v = 0; v < capacity; v++) {
+        position[v] = -1;       // Not in the heap
+    }
+    size = 0;
+}
+
+IndexedHeap::~IndexedHeap() {
+    delete[] heap;
+    delete[] position;
+}
+
+void IndexedHeap::siftUp(int i) {
+    Item item = heap[i];
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (heap[parent].priority <= item.priority) break;
+        heap[i] = heap[parent];             // Move parent down
+        position[heap[i].vertex] = i;
+        i = parent;
+    }
+    heap[i] = item;
+    position[item.vertex] = i;
+}
+
+void IndexedHeap::siftDown(int i) {
+    Item item = heap[i];
+    while (2 * i + 1 < size) {
+        int child = 2 * i + 1;
+        if (child + 1 < size && heap[child + 1].priority < heap[child].priority) child++;
+        if (item.priority <= heap[child].priority) break;
+        heap[i] = heap[child];              // Move smaller child up
+        position[heap[i].vertex] = i;
+        i = child;
+    }
+    heap[i] = item;
+    position[item.vertex] = i;
+}
+
+bool IndexedHeap::pushOrDecrease(int v, int p) {
+    if (v < 0 || v >= capacity) {
+        throw "Invalid vertex!";
+    }
+    int i = position[v];
+    if (i == -1) {              // New vertex at the bottom
+        i = size++;
+        heap[i].vertex = v;
+    } else if (heap[i].priority <= p) {
+        return false;
+    }
+    heap[i].priority = p;
+    siftUp(i);
+    return true;
+}
+
+IndexedHeap::Item IndexedHeap::popMin() {
+    if (isEmpty()) {
+        throw "Priority queue is empty!";
+    }
+    Item minItem = heap[0];
+    position[minItem.vertex] = -1;
+    size--;
+    if (size > 0) {             // Move the last item to the root and restore the order
+        heap[0] = heap[size];
+        siftDown(0);
+    }
+    return minItem;
+}
+
+bool IndexedHeap::isEmpty() const {
+    return size == 0;
+}
+
+bool IndexedHeap::contains(int v) const {
+    return v >= 0 && v < capacity && position[v] != -1;
+}
+
+void IndexedHeap::clear() {
+    for (int i = 0; i < size; i++) {
+        position[heap[i].vertex] = -1;
+    }
+    size = 0;
+}
+
 // --- UnionFind ---
 // Implements Disjoint Set Union (DSU) with Path Compression and Union by Rank.
 
@@ -148,4 +395,459 @@ void UnionFind::unionSets(int x, int y) {
     }
 }
 
+// --- RollbackUnionFind ---
+
+RollbackUnionFind::RollbackUnionFind(int n) {
+    size = n;
+    int cap = n > 0 ? n : 1;
+    parent = new int[cap];
+    rank = new int[cap];
+    history = new int[cap];     // At most n - 1 unions are in effect at a time
+    rankRaised = new bool[cap];
+    for (int i = 0; i < n; i++) {
+        parent[i] = i;
+        rank[i] = 0;
+    }
+    historySize = 0;
+    components = n;
+}
+
+RollbackUnionFind::~RollbackUnionFind() {
+    delete[] parent;
+    delete[] rank;
+    delete[] history;
+    delete[] rankRaised;
+}
+
+int RollbackUnionFind::find(int x) const {
+    if (x < 0 || x >= size) {
+        throw "Invalid vertex in find!";
+    }
+    while (parent[x] != x) {    // No path compression: it could not be undone cheaply
+        x = parent[x];
+    }
+    return x;
+}
+
+bool RollbackUnionFind::unionSets(int x, int y) {
+    int rootX = find(x);
+    int rootY = find(y);
+    if (rootX == rootY) {
+        return false;
+    }
+    if (rank[rootX] < rank[rootY]) {    // Attach the lower tree (rootY) under the higher
+        int tmp = rootX;
+        rootX = rootY;
+        rootY = tmp;
+    }
+    parent[rootY] = rootX;
+    rankRaised[historySize] = rank[rootX] == rank[rootY];
+    if (rankRaised[historySize]) {
+        rank[rootX]++;
+    }
+    history[historySize++] = rootY;
+    components--;
+    return true;
+}
+
+void RollbackUnionFind::rollback(int snapshot) {
+    if (snapshot < 0 || snapshot > historySize) {
+        throw "Invalid snapshot!";
+    }
+    while (historySize > snapshot) {
+        historySize--;
+        int child = history[historySize];
+        int root = parent[child];
+        if (rankRaised[historySize]) {
+            rank[root]--;
+        }
+        parent[child] = child;
+        components++;
+    }
+}
+
+// --- EdgeMap ---
+
+EdgeMap::EdgeMap(int expected) {
+    int tableSize = 16;
+    while (tableSize < 2 * (long long)expected) tableSize *= 2;
+    mask = tableSize - 1;
+    keys = new long long[tableSize];
+    values = new int[tableSize];
+    for (int i = 0; i < tableSize; i++) {
+        keys[i] = -1;
+    }
+    count = 0;
+}
+
+EdgeMap::~EdgeMap() {
+    delete[] keys;
+    delete[] values;
+}
+
+int EdgeMap::home(long long key) const {
+    return (int)(((unsigned long long)key * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+}
+
+void EdgeMap::grow() {
+    long long* oldKeys = keys;
+    int* oldValues = values;
+    int oldSize = mask + 1;
+    mask = 2 * oldSize - 1;
+    keys = new long long[mask + 1];
+    values = new int[mask + 1];
+    for (int i = 0; i <= mask; i++) {
+        keys[i] = -1;
+    }
+    for (int i = 0; i < oldSize; i++) {
+        if (oldKeys[i] == -1) continue;
+        int j = home(oldKeys[i]);
+        while (keys[j] != -1) {
+            j = (j + 1) & mask;
+        }
+        keys[j] = oldKeys[i];
+        values[j] = oldValues[i];
+    }
+    delete[] oldKeys;
+    delete[] oldValues;
+}
+
+int EdgeMap::find(int u, int v) const {
+    long long key = keyOf(u, v);
+    for (int i = home(key); keys[i] != -1; i = (i + 1) & mask) {
+        if (keys[i] == key) return values[i];
+    }
+    return -1;
+}
+
+void EdgeMap::insert(int u, int v, int value) {
+    if (2 * (count + 1) > mask + 1) {
+        grow();
+    }
+    long long key = keyOf(u, v);
+    int i = home(key);
+    while (keys[i] != -1) {
+        if (keys[i] == key) {
+            throw "Edge already exists!";
+        }
+        i = (i + 1) & mask;
+    }
+    keys[i] = key;
+    values[i] = value;
+    count++;
+}
+
+bool EdgeMap::erase(int u, int v) {
+    long long key = keyOf(u, v);
+    int i = home(key);
+    while (keys[i] != key) {
+        if (keys[i] == -1) return false;
+        i = (i + 1) & mask;
+    }
+    for (int j = (i + 1) & mask; keys[j] != -1; j = (j + 1) & mask) {
+        int k = home(keys[j]);
+        // keys[j] can fill the hole at i unless its home lies cyclically in (i, j]
+        bool reachable = i <= j ? (i < k && k <= j) : (i < k || k <= j);
+        if (!reachable) {
+            keys[i] = keys[j];
+            values[i] = values[j];
+            i = j;
+        }
+    }
+    keys[i] = -1;
+    count--;
+    return true;
+}
+
+// --- LinkCutTree ---
+
+LinkCutTree::LinkCutTree(int n) {
+    capacity = n > 0 ? n : 1;
+    nodes = new Node[capacity];
+    pushStack = new int[capacity];
+    for (int x = 0; x < capacity; x++) {
+        nodes[x].child[0] = nodes[x].child[1] = -1;
+        nodes[x].parent = -1;
+        nodes[x].value = INT_MIN;
+        nodes[x].valueSet = false;
+        nodes[x].best = x;
+        nodes[x].flip = false;
+    }
+}
+
+LinkCutTree::~LinkCutTree() {
+    delete[] nodes;
+    delete[] pushStack;
+}
+
+bool LinkCutTree::isSplayRoot(int x) const {
+    int p = nodes[x].parent;
+    return p == -1 || (nodes[p].child[0] != x && nodes[p].child[1] != x);
+}
+
+void LinkCutTree::push(int x) {
+    Node& node = nodes[x];
+    if (!node.flip) return;
+    int tmp = node.child[0];
+    node.child[0] = node.child[1];
+    node.child[1] = tmp;
+    for (int c : node.child) {
+        if (c != -1) nodes[c].flip = !nodes[c].flip;
+    }
+    node.flip = false;
+}
+
+void LinkCutTree::pull(int x) {
+    Node& node = nodes[x];
+    node.best = x;
+    for (int c : node.child) {
+        if (c == -1) continue;
+        const Node& a = nodes[nodes[c].best];
+        const Node& b = nodes[node.best];
+        // Compare (value, valueSet): an unset INT_MIN node never beats a set INT_MIN one
+        if (a.value > b.value || (a.value == b.value && a.valueSet && !b.valueSet)) {
+            node.best = nodes[c].best;
+        }
+    }
+}
+
+void LinkCutTree::rotate(int x) {
+    int p = nodes[x].parent;
+    int g = nodes[p].parent;
+    int dir = nodes[p].child[1] == x;
+    if (!isSplayRoot(p)) {
+        nodes[g].child[nodes[g].child[1] == p] = x;
+    }
+    nodes[x].parent = g;    // Also hands the path parent over to x
+    int inner = nodes[x].child[1 - dir];
+    nodes[p].child[dir] = inner;
+    if (inner != -1) nodes[inner].parent = p;
+    nodes[x].child[1 - dir] = p;
+    nodes[p].parent = x;
+    pull(p);
+    pull(x);
+}
+
+void LinkCutTree::splay(int x) {
+    // Push pending flips from the splay root down to x (iteratively: paths can be long)
+    int depth = 0;
+    for (int y = x; ; y = nodes[y].parent) {
+        pushStack[depth++] = y;
+        if (isSplayRoot(y)) break;
+    }
+    while (depth > 0) {
+        push(pushStack[--depth]);
+    }
+
+    while (!isSplayRoot(x)) {
+        int p = nodes[x].parent;
+        if (!isSplayRoot(p)) {
+            int g = nodes[p].parent;
+            bool zigzig = (nodes[g].child[1] == p) == (nodes[p].child[1] == x);
+            rotate(zigzig ? p : x);
+        }
+        rotate(x);
+    }
+}
+
+void LinkCutTree::access(int x) {
+    int last = -1;
+    for (int y = x; y != -1; y = nodes[y].parent) {
+        splay(y);
+        nodes[y].child[1] = last;   // The path continues into last, not below y
+        pull(y);
+        last = y;
+    }
+    splay(x);
+}
+
+void LinkCutTree::makeRoot(int x) {
+    access(x);
+    nodes[x].flip = !nodes[x].flip;
+}
+
+int LinkCutTree::findRoot(int x) {
+    access(x);
+    push(x);
+    while (nodes[x].child[0] != -1) {   // Shallowest node of the root path
+        x = nodes[x].child[0];
+        push(x);
+    }
+    splay(x);
+    return x;
+}
+
+void LinkCutTree::setValue(int x, int value) {
+    if (x < 0 || x >= capacity) {
+        throw "Invalid vertex!";
+    }
+    splay(x);               // Only x's own aggregate depends on it now
+    nodes[x].value = value;
+    nodes[x].valueSet = true;
+    pull(x);
+}
+
+int LinkCutTree::getValue(int x) const {
+    if (x < 0 || x >= capacity) {
+        throw "Invalid vertex!";
+    }
+    return nodes[x].value;
+}
+
+void LinkCutTree::link(int u, int v) {
+    if (u < 0 || u >= capacity || v < 0 || v >= capacity) {
+        throw "Invalid vertex!";
+    }
+    makeRoot(u);
+    if (findRoot(v) == u) {
+        throw "Vertices are already connected!";
+    }
+    nodes[u].parent = v;    // u is the root of its tree and of its splay tree
+}
+
+void LinkCutTree::cut(int u, int v) {
+    if (u < 0 || u >= capacity || v < 0 || v >= capacity) {
+        throw "Invalid vertex!";
+    }
+    makeRoot(u);
+    access(v);
+    // The root path is exactly u - v iff u is v's left child with nothing right of it
+    int left = nodes[v].child[0];
+    if (left != u) {
+        throw "Edge does not exist!";
+    }
+    push(u);
+    if (nodes[u].child[1] != -1) {
+        throw "Edge does not exist!";
+    }
+    nodes[v].child[0] = -1;
+    nodes[u].parent = -1;
+    pull(v);
+}
+
+bool LinkCutTree::connected(int u, int v) {
+    if (u < 0 || u >= capacity || v < 0 || v >= capacity) {
+        throw "Invalid vertex!";
+    }
+    if (u == v) return true;
+    return findRoot(u) == findRoot(v);
+}
+
+int LinkCutTree::pathMax(int u, int v) {
+    if (u < 0 || u >= capacity || v < 0 || v >= capacity) {
+        throw "Invalid vertex!";
+    }
+    makeRoot(u);
+    if (findRoot(v) != u) return -1;
+    access(v);              // v's splay tree is now the path u - v
+    return nodes[v].best;
+}
+
+// --- SlabArena ---
+
+SlabArena::SlabArena() {
+    for (int k = 0; k < NUM_CLASSES; k++) {
+        freeLists[k] = nullptr; // All free lists start empty
+    }
+    slabs = nullptr;            // No slabs until the first allocation
+    numSlabs = 0;
+    slabCapacity = 0;
+    cursor = nullptr;
+    remaining = 0;
+    nextSlabInts = MIN_SLAB_INTS;
+    reservedInts = 0;
+    owners = 1;                 // The creator is the first owner
+}
+
+SlabArena::~SlabArena() {
+    for (int i = 0; i < numSlabs; i++) {
+        delete[] slabs[i];      // One free per slab
+    }
+    delete[] slabs;
+}
+
+// Smallest k such that 2^k >= ints (blocks hold at least 2 ints for the free list link)
+int SlabArena::sizeClass(int ints) {
+    if (ints < 2) ints = 2;
+    int k = 1;
+    while ((1 << k) < ints) {
+        k++;
+    }
+    if (k >= NUM_CLASSES) {
+        throw "Block too large for arena!";
+    }
+    return k;
+}
+
+int SlabArena::roundUp(int ints) {
+    return 1 << sizeClass(ints);
+}
+
+// Allocate a new slab and remember it for the bulk free
+int* SlabArena::newSlab(int ints) {
+    if (numSlabs == slabCapacity) { // Grow the slab list by doubling
+        int newCapacity = slabCapacity == 0 ? 8 : slabCapacity * 2;
+        int** newSlabs = new int*[newCapacity];
+        for (int i = 0; i < numSlabs; i++) {
+            newSlabs[i] = slabs[i];
+        }
+        delete[] slabs;
+        slabs = newSlabs;
+        slabCapacity = newCapacity;
+    }
+    int* slab = new int[ints];
+    slabs[numSlabs++] = slab;
+    reservedInts += ints;
+    return slab;
+}
+
+int* SlabArena::allocate(int ints) {
+    int k = sizeClass(ints);
+    int blockInts = 1 << k;
+    if (freeLists[k] != nullptr) { // Reuse a freed block of the same class
+        int* block = freeLists[k];
+        int* next;
+        std::memcpy(&next, block, sizeof(next));
+        freeLists[k] = next;
+        return block;
+    }
+    if (blockInts > nextSlabInts / 2) { // Large blocks get a dedicated slab
+        return newSlab(blockInts);
+    }
+    if (remaining < blockInts) { // Current slab exhausted, the rest of it is abandoned
+        cursor = newSlab(nextSlabInts);
+        remaining = nextSlabInts;
+        if (nextSlabInts < MAX_SLAB_INTS) {
+            nextSlabInts *= 2;
+        }
+    }
+    int* block = cursor;
+    cursor += blockInts;
+    remaining -= blockInts;
+    return block;
+}
+
+void SlabArena::deallocate(int* block, int ints) {
+    if (block == nullptr) return;
+    int k = sizeClass(ints);
+    std::memcpy(block, &freeLists[k], sizeof(int*)); // Link into the class free list
+    freeLists[k] = block;
+}
+
+void SlabArena::addOwner() {
+    owners++;
+}
+
+int SlabArena::removeOwner() {
+    return --owners;
+}
+
+int SlabArena::ownerCount() const {
+    return owners;
+}
+
+long long SlabArena::bytesReserved() const {
+    return reservedInts * (long long)sizeof(int);
+}
+
 } // namespace graph
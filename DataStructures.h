@@ -3,6 +3,8 @@
 #ifndef DATA_STRUCTURES_H
 #define DATA_STRUCTURES_H
 
+#include <atomic>
+
 namespace graph {
 
 class Queue {
@@ -13,12 +15,50 @@ private:
     int rear;
     int size;
 
+    void grow();                // Double the capacity, items move to [0, size)
+
 public:
     Queue(int cap);
     ~Queue();
     void enqueue(int x);
+    void pushFront(int x);      // Insert at the front (dequeued next)
     int dequeue();
+    int peek() const;           // Front item without removing it
     bool isEmpty();
+    int getSize() const;
+};
+
+// Bounded lock-free multi-producer / multi-consumer queue of ints (Vyukov's ring).
+// The capacity is rounded up to a power of two. Every cell carries a sequence number that
+// tells producers and consumers whose turn it is, so a push or pop is one CAS on head or
+// tail plus one release store on the cell; head and tail sit on separate cache lines.
+// Operations never block: tryEnqueue fails when the queue is full, tryDequeue when empty.
+class MPMCQueue {
+private:
+    struct Cell {
+        std::atomic<unsigned long long> sequence;   // Position this cell is ready for
+        int value;
+    };
+
+    Cell* cells;
+    unsigned long long mask;    // capacity - 1
+    alignas(64) std::atomic<unsigned long long> head;   // Next position to enqueue
+    alignas(64) std::atomic<unsigned long long> tail;   // Next position to dequeue (own line)
+
+public:
+    MPMCQueue(int cap);
+    ~MPMCQueue();
+    MPMCQueue(const MPMCQueue&) = delete;
+    MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+    bool tryEnqueue(int x);
+    bool tryDequeue(int& x);
+    // Claim up to count consecutive positions with one CAS. Return the number of items moved.
+    int enqueueBatch(const int* items, int count);
+    int dequeueBatch(int* items, int maxCount);
+
+    int capacity() const;
+    int sizeEstimate() const;   // Exact only when no other thread is using the queue
 };
 
 class PriorityQueue {
@@ -41,6 +81,40 @@ public:
     bool isEmpty();
 };
 
+// Binary min-heap of vertices in [0, n) with decrease-key; a vertex is in the heap at most once.
+// Vertices not in the heap have position -1, so clear() costs O(size) and one heap can be
+// reused by many queries without touching all n entries.
+class IndexedHeap {
+public:
+    struct Item {
+        int vertex;
+        int priority;
+    };
+
+private:
+    Item* heap;                 // Heap order
+    int* position;              // Index of each vertex in heap, -1 if absent
+    int capacity;
+    int size;
+
+    void siftUp(int i);
+    void siftDown(int i);
+
+public:
+    IndexedHeap(int n);
+    ~IndexedHeap();
+    IndexedHeap(const IndexedHeap&) = delete;
+    IndexedHeap& operator=(const IndexedHeap&) = delete;
+
+    // Insert v, or lower its priority if it is already in the heap.
+    // Returns false if v is in the heap with a priority <= p (nothing changes).
+    bool pushOrDecrease(int v, int p);
+    Item popMin();
+    bool isEmpty() const;
+    bool contains(int v) const;
+    void clear();
+};
+
 class UnionFind {
 private:
     int* parent;
@@ -55,6 +129,145 @@ public:
     void unionSets(int x, int y);
 };
 
+// Hash map from unordered vertex pairs {u, v} to non-negative ints (e.g. edge ids).
+// Open addressing with linear probing and backward shift deletion (no tombstones); the
+// table doubles when it is half full.
+class EdgeMap {
+private:
+    long long* keys;            // (min << 32) | max, -1 if the cell is empty
+    int* values;
+    int mask;                   // Table size - 1
+    int count;
+
+    static long long keyOf(int u, int v) {
+        return u < v ? ((long long)u << 32) | (unsigned int)v : ((long long)v << 32) | (unsigned int)u;
+    }
+    int home(long long key) const;
+    void grow();
+
+public:
+    EdgeMap(int expected = 16);
+    ~EdgeMap();
+    EdgeMap(const EdgeMap&) = delete;
+    EdgeMap& operator=(const EdgeMap&) = delete;
+
+    int find(int u, int v) const;           // -1 if the pair is absent
+    void insert(int u, int v, int value);   // Throws if the pair is already present
+    bool erase(int u, int v);               // Returns false if the pair was absent
+    int size() const { return count; }
+};
+
+// Link-cut tree over nodes [0, n): a forest of rooted trees under link and cut, where each
+// node has a value and pathMax returns the node with the largest value on a tree path.
+// Every tree path is stored as a splay tree keyed by depth (with a lazy reversal flag, so
+// any node can be made the root), and all operations take O(log n) amortized time.
+// Queries splay, so even they modify the structure. Values start at INT_MIN; a node whose
+// value was never set loses every tie against one that was, so pathMax only returns an
+// unset node on a path without set nodes.
+class LinkCutTree {
+private:
+    struct Node {
+        int child[2];
+        int parent;         // Splay parent, or path parent for the root of a splay tree
+        int value;
+        bool valueSet;      // setValue was called (wins ties against unset nodes)
+        int best;           // Node with the largest value in this splay subtree
+        bool flip;          // Children of the subtree must be swapped
+    };
+
+    Node* nodes;
+    int* pushStack;         // Scratch of splay: the nodes above x, pushed top-down
+    int capacity;
+
+    bool isSplayRoot(int x) const;
+    void push(int x);
+    void pull(int x);
+    void rotate(int x);
+    void splay(int x);
+    void access(int x);     // x becomes the deepest node of the root path's splay tree
+    void makeRoot(int x);
+    int findRoot(int x);
+
+public:
+    LinkCutTree(int n);
+    ~LinkCutTree();
+    LinkCutTree(const LinkCutTree&) = delete;
+    LinkCutTree& operator=(const LinkCutTree&) = delete;
+
+    void setValue(int x, int value);
+    int getValue(int x) const;
+    void link(int u, int v);        // Throws if u and v are already connected
+    void cut(int u, int v);         // Throws if there is no tree edge u - v
+    bool connected(int u, int v);
+    int pathMax(int u, int v);      // -1 if u and v are not connected
+};
+
+// Union-find whose unions can be undone in LIFO order: union by rank without path
+// compression, so every union changes one parent pointer (and maybe one rank) and
+// find is O(log n). rollback(snapshot()) undoes every union made since the snapshot.
+class RollbackUnionFind {
+private:
+    int* parent;
+    int* rank;
+    int* history;               // Root attached by each union still in effect
+    bool* rankRaised;           // Whether that union raised the new root's rank
+    int historySize;
+    int size;
+    int components;
+
+public:
+    RollbackUnionFind(int n);
+    ~RollbackUnionFind();
+    RollbackUnionFind(const RollbackUnionFind&) = delete;
+    RollbackUnionFind& operator=(const RollbackUnionFind&) = delete;
+
+    int find(int x) const;
+    bool unionSets(int x, int y);   // False if x and y were already in the same set
+    int snapshot() const { return historySize; }
+    void rollback(int snapshot);
+    int numComponents() const { return components; }
+};
+
+// Size-class slab allocator for blocks of ints.
+// Block sizes are rounded up to a power of two; freed blocks go to a per-class free list
+// and are reused by later allocations of the same class. Memory is carved out of a few
+// large slabs (each slab twice the size of the previous one), so destroying the arena is
+// a handful of bulk frees no matter how many blocks were handed out.
+// The arena can be shared by several owners (e.g. graph copies); the last owner deletes it.
+class SlabArena {
+private:
+    static const int NUM_CLASSES = 31;
+    static const int MIN_SLAB_INTS = 1 << 10;
+    static const int MAX_SLAB_INTS = 1 << 20;
+
+    int* freeLists[NUM_CLASSES];    // Head of the free list for each size class
+    int** slabs;                    // All slabs, freed together in the destructor
+    int numSlabs;
+    int slabCapacity;
+    int* cursor;                    // Bump pointer in the current slab
+    int remaining;                  // Ints left in the current slab
+    int nextSlabInts;
+    long long reservedInts;
+    int owners;
+
+    static int sizeClass(int ints);
+    int* newSlab(int ints);
+
+public:
+    SlabArena();
+    ~SlabArena();
+    SlabArena(const SlabArena&) = delete;
+    SlabArena& operator=(const SlabArena&) = delete;
+
+    int* allocate(int ints);            // At least 'ints' ints (rounded up to a power of two)
+    void deallocate(int* block, int ints);  // 'ints' must match the allocation request
+    static int roundUp(int ints);       // Actual block size used for a request
+
+    void addOwner();
+    int removeOwner();                  // Returns the number of remaining owners
+    int ownerCount() const;
+    long long bytesReserved() const;
+};
 }
 
 #endif
@@ -0,0 +1,482 @@
+// michael9090124@gmail.com
+
+#include "DynamicConnectivity.h"
+#include "DataStructures.h"
+
+namespace graph {
+
+// Reallocate a[0..used) into a larger array
+template <class T>
+static void growArray(T*& a, int used, int capacity) {
+    T* larger = new T[capacity];
+    for (int i = 0; i < used; i++) {
+        larger[i] = a[i];
+    }
+    delete[] a;
+    a = larger;
+}
+
+template <class GraphT>
+BasicDynamicConnectivity<GraphT>::BasicDynamicConnectivity(GraphT& graph)
+    : g(graph), n(graph.getNumVertices()) {
+    levels = 1;
+    while ((1LL << levels) <= n) levels++;  // Trees of F_i have at most n / 2^i vertices
+    components = n;
+
+    nodeCapacity = 2 * n + 16;
+    nodes = new Node[nodeCapacity];
+    numNodes = 0;
+    freeNode = -1;
+    vertexNode = new int*[levels]();
+    treeHead = new int*[levels]();
+    nonTreeHead = new int*[levels]();
+    ensureLevel(0);
+    for (int v = 0; v < n; v++) {
+        vnode(0, v);
+    }
+
+    edgeCapacity = 16;
+    edgeOf = new EdgeMap(edgeCapacity);
+    edgeU = new int[edgeCapacity];
+    edgeV = new int[edgeCapacity];
+    edgeLevel = new int[edgeCapacity];
+    edgeTree = new bool[edgeCapacity];
+    edgeArc = new int[edgeCapacity];
+    endPrev = new int[2 * edgeCapacity];
+    endNext = new int[2 * edgeCapacity];
+    numEdges = 0;
+    freeEdge = -1;
+
+    for (int u = 0; u < n; u++) {
+        for (Edge e : g.edges(u)) {
+            if (u < e.dst) edgeAdded(u, e.dst, e.w);
+        }
+    }
+    g.attach(this);
+}
+
+template <class GraphT>
+BasicDynamicConnectivity<GraphT>::~BasicDynamicConnectivity() {
+    g.detach(this);
+    delete[] nodes;
+    for (int i = 0; i < levels; i++) {
+        delete[] vertexNode[i];
+        delete[] treeHead[i];
+        delete[] nonTreeHead[i];
+    }
+    delete[] vertexNode;
+    delete[] treeHead;
+    delete[] nonTreeHead;
+    delete edgeOf;
+    delete[] edgeU;
+    delete[] edgeV;
+    delete[] edgeLevel;
+    delete[] edgeTree;
+    delete[] edgeArc;
+    delete[] endPrev;
+    delete[] endNext;
+}
+
+// --- Euler tour trees (splay trees ordered by tour position) ---
+
+template <class GraphT>
+int BasicDynamicConnectivity<GraphT>::newNode(int vertex) {
+    int x = freeNode;
+    if (x != -1) {
+        freeNode = nodes[x].next;
+    } else {
+        if (numNodes == nodeCapacity) {
+            nodeCapacity *= 2;
+            growArray(nodes, numNodes, nodeCapacity);
+        }
+        x = numNodes++;
+    }
+    Node& node = nodes[x];
+    node.child[0] = node.child[1] = -1;
+    node.parent = -1;
+    node.size = vertex >= 0 ? 1 : 0;
+    node.vertex = vertex;
+    node.next = -1;
+    node.hasTree = node.hasNonTree = false;
+    node.anyTree = node.anyNonTree = false;
+    return x;
+}
+
+template <class GraphT>
+void BasicDynamicConnectivity<GraphT>::pull(int x) {
+    Node& node = nodes[x];
+    node.size = node.vertex >= 0 ? 1 : 0;
+    node.anyTree = node.hasTree;
+    node.anyNonTree = node.hasNonTree;
+    for (int c : node.child) {
+        if (c == -1) continue;
+        node.size += nodes[c].size;
+        node.anyTree |= nodes[c].anyTree;
+        node.anyNonTree |= nodes[c].anyNonTree;
+    }
+}
+
+template <class GraphT>
+void BasicDynamicConnectivity<GraphT>::rotate(int x) {
+    int p = nodes[x].parent;
+    int gp = nodes[p].parent;
+    int dir = nodes[p].child[1] == x;
+    int inner = nodes[x].child[1 - dir];
+    nodes[p].child[dir] = inner;
+    if (inner != -1) nodes[inner].parent = p;
+    nodes[x].child[1 - dir] = p;
+    nodes[p].parent = x;
+    nodes[x].parent = gp;
+    if (gp != -1) nodes[gp].child[nodes[gp].child[1] == p] = x;
+    pull(p);
+    pull(x);
+}
+
+template <class GraphT>
+void BasicDynamicConnectivity<GraphT>::splay(int x) {
+    while (nodes[x].parent != -1) {
+        int p = nodes[x].parent;
+        int gp = nodes[p].parent;
+        if (gp != -1) {
+            bool zigzig = (nodes[gp].child[1] == p) == (nodes[p].child[1] == x);
+            rotate(zigzig ? p : x);
+        }
+        rotate(x);
+    }
+}
+
+template <class GraphT>
+int BasicDynamicConnectivity<GraphT>::rootOf(int x) {
+    splay(x);
+    return x;
+}
+
+// After splay(x) and splay(y), x has a parent only if y's splay brought it down
+template <class GraphT>
+bool BasicDynamicConnectivity<GraphT>::sameTree(int x, int y) {
+    if (x == y) return true;
+    splay(x);
+    splay(y);
+    return nodes[x].parent != -1;
+}
+
+// Concatenate the tours rooted at a and b (either may be -1), returns the new root
+template <class GraphT>
+int BasicDynamicConnectivity<GraphT>::merge(int a, int b) {
+    if (a == -1) return b;
+    if (b == -1) return a;
+    int last = a;
+    while (nodes[last].child[1] != -1) {
+        last = nodes[last].child[1];
+    }
+    splay(last);
+    nodes[last].child[1] = b;
+    nodes[b].parent = last;
+    pull(last);
+    return last;
+}
+
+// Rotate the tour so that it starts at x
+template <class GraphT>
+void BasicDynamicConnectivity<GraphT>::reroot(int x) {
+    splay(x);
+    int before = nodes[x].child[0];
+    if (before == -1) return;
+    nodes[x].child[0] = -1;
+    nodes[before].parent = -1;
+    pull(x);
+    merge(x, before);
+}
+
+// Tour(u) + (u -> v) + tour(v) + (v -> u)
+template <class GraphT>
+void BasicDynamicConnectivity<GraphT>::linkTours(int level, int u, int v, int arcUV, int arcVU) {
+    int nu = vnode(level, u);
+    int nv = vnode(level, v);
+    reroot(nu);
+    reroot(nv);
+    int tour = merge(rootOf(nu), arcUV);
+    tour = merge(tour, rootOf(nv));
+    merge(tour, arcVU);
+}
+
+// L a M b R -> L R and M; both arcs go back to the free list
+template <class GraphT>
+void BasicDynamicConnectivity<GraphT>::cutTours(int arcA, int arcB) {
+    splay(arcA);
+    splay(arcB);
+    int x = arcA;           // Find the side of arcB that arcA is on (arcA is near the top)
+    while (nodes[x].parent != arcB) {
+        x = nodes[x].parent;
+    }
+    int first = arcA, second = arcB;
+    if (nodes[arcB].child[1] == x) {
+        first = arcB;
+        second = arcA;
+    }
+
+    splay(first);
+    int left = nodes[first].child[0];
+    if (left != -1) {
+        nodes[left].parent = -1;
+        nodes[first].child[0] = -1;
+        pull(first);
+    }
+    splay(second);
+    int right = nodes[second].child[1];
+    if (right != -1) {
+        nodes[right].parent = -1;
+        nodes[second].child[1] = -1;
+        pull(second);
+    }
+    splay(first);           // first M second, first has no left child
+    int middle = nodes[first].child[1];
+    nodes[middle].parent = -1;
+    splay(second);          // M second, second has no right child
+    int inner = nodes[second].child[0];
+    if (inner != -1) nodes[inner].parent = -1;
+    merge(left, right);
+
+    nodes[first].next = second;
+    nodes[second].next = freeNode;
+    freeNode = first;
+}
+
+// Vertex of x's tree whose flag is set, or -1
+template <class GraphT>
+int BasicDynamicConnectivity<GraphT>::findFlagged(int x, bool tree) {
+    splay(x);
+    if (!(tree ? nodes[x].anyTree : nodes[x].anyNonTree)) return -1;
+    while (true) {
+        int left = nodes[x].child[0];
+        if (left != -1 && (tree ? nodes[left].anyTree : nodes[left].anyNonTree)) {
+            x = left;
+        } else if (tree ? nodes[x].hasTree : nodes[x].hasNonTree) {
+            break;
+        } else {
+            x = nodes[x].child[1];
+        }
+    }
+    splay(x);
+    return nodes[x].vertex;
+}
+
+// --- Levels and edge lists ---
+
+template <class GraphT>
+void BasicDynamicConnectivity<GraphT>::ensureLevel(int level) {
+    if (vertexNode[level] != nullptr) return;
+    int size = n > 0 ? n : 1;
+    vertexNode[level] = new int[size];
+    treeHead[level] = new int[size];
+    nonTreeHead[level] = new int[size];
+    for (int v = 0; v < size; v++) {
+        vertexNode[level][v] = treeHead[level][v] = nonTreeHead[level][v] = -1;
+    }
+}
+
+template <class GraphT>
+int BasicDynamicConnectivity<GraphT>::vnode(int level, int v) {
+    ensureLevel(level);
+    if (vertexNode[level][v] == -1) {
+        vertexNode[level][v] = newNode(v);
+    }
+    return vertexNode[level][v];
+}
+
+template <class GraphT>
+void BasicDynamicConnectivity<GraphT>::updateFlags(int level, int v) {
+    int x = vnode(level, v);
+    splay(x);               // Only x's aggregates depend on its flags now
+    nodes[x].hasTree = treeHead[level][v] != -1;
+    nodes[x].hasNonTree = nonTreeHead[level][v] != -1;
+    pull(x);
+}
+
+template <class GraphT>
+void BasicDynamicConnectivity<GraphT>::listInsert(int* heads, int end) {
+    int v = (end & 1) ? edgeV[end >> 1] : edgeU[end >> 1];
+    endPrev[end] = -1;
+    endNext[end] = heads[v];
+    if (heads[v] != -1) endPrev[heads[v]] = end;
+    heads[v] = end;
+}
+
+template <class GraphT>
+void BasicDynamicConnectivity<GraphT>::listRemove(int* heads, int end) {
+    int v = (end & 1) ? edgeV[end >> 1] : edgeU[end >> 1];
+    if (endPrev[end] != -1) endNext[endPrev[end]] = endNext[end];
+    else heads[v] = endNext[end];
+    if (endNext[end] != -1) endPrev[endNext[end]] = endPrev[end];
+}
+
+template <class GraphT>
+void BasicDynamicConnectivity<GraphT>::listEdge(int e) {
+    int level = edgeLevel[e];
+    ensureLevel(level);
+    int* heads = headsOf(e, level);
+    listInsert(heads, 2 * e);
+    listInsert(heads, 2 * e + 1);
+    updateFlags(level, edgeU[e]);
+    updateFlags(level, edgeV[e]);
+}
+
+template <class GraphT>
+void BasicDynamicConnectivity<GraphT>::unlistEdge(int e) {
+    int level = edgeLevel[e];
+    int* heads = headsOf(e, level);
+    listRemove(heads, 2 * e);
+    listRemove(heads, 2 * e + 1);
+    updateFlags(level, edgeU[e]);
+    updateFlags(level, edgeV[e]);
+}
+
+// Add tree edge e to F_fromLevel .. F_toLevel, extending its arc chain
+// (u -> v and v -> u of level 0, then of level 1, ...)
+template <class GraphT>
+void BasicDynamicConnectivity<GraphT>::linkTreeEdge(int e, int fromLevel, int toLevel) {
+    int last = -1;
+    if (fromLevel > 0) {
+        last = edgeArc[e];
+        while (nodes[last].next != -1) {
+            last = nodes[last].next;
+        }
+    }
+    for (int level = fromLevel; level <= toLevel; level++) {
+        int arcUV = newNode(-1);
+        int arcVU = newNode(-1);
+        nodes[arcUV].next = arcVU;
+        if (last == -1) edgeArc[e] = arcUV;
+        else nodes[last].next = arcUV;
+        last = arcVU;
+        linkTours(level, edgeU[e], edgeV[e], arcUV, arcVU);
+    }
+}
+
+// The tree edge u - v of the given level was cut: look for a replacement edge
+template <class GraphT>
+bool BasicDynamicConnectivity<GraphT>::replace(int u, int v, int level) {
+    for (int i = level; i >= 0; i--) {
+        int nu = vnode(i, u);
+        int nv = vnode(i, v);
+        splay(nu);
+        int sizeU = nodes[nu].size;
+        splay(nv);
+        int small = sizeU <= nodes[nv].size ? nu : nv;
+
+        // The smaller half fits in a tree of level i + 1: its level i tree edges move up
+        int w;
+        while ((w = findFlagged(small, true)) != -1) {
+            while (treeHead[i][w] != -1) {
+                int e = treeHead[i][w] >> 1;
+                unlistEdge(e);
+                edgeLevel[e] = i + 1;
+                listEdge(e);
+                linkTreeEdge(e, i + 1, i + 1);
+            }
+        }
+
+        // Non-tree edges of level i: inside the half they move up, leaving it they reconnect
+        while ((w = findFlagged(small, false)) != -1) {
+            while (nonTreeHead[i][w] != -1) {
+                int end = nonTreeHead[i][w];
+                int e = end >> 1;
+                int other = (end & 1) ? edgeU[e] : edgeV[e];
+                unlistEdge(e);
+                if (sameTree(vnode(i, other), small)) {
+                    edgeLevel[e] = i + 1;
+                    listEdge(e);
+                } else {
+                    edgeTree[e] = true;
+                    listEdge(e);
+                    linkTreeEdge(e, 0, i);
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+// --- Public interface ---
+
+template <class GraphT>
+void BasicDynamicConnectivity<GraphT>::edgeAdded(int u, int v, int w) {
+    (void)w;
+    int e = freeEdge;
+    if (e != -1) {
+        freeEdge = endNext[2 * e];
+    } else {
+        if (numEdges == edgeCapacity) {
+            int capacity = 2 * edgeCapacity;
+            growArray(edgeU, numEdges, capacity);
+            growArray(edgeV, numEdges, capacity);
+            growArray(edgeLevel, numEdges, capacity);
+            growArray(edgeTree, numEdges, capacity);
+            growArray(edgeArc, numEdges, capacity);
+            growArray(endPrev, 2 * numEdges, 2 * capacity);
+            growArray(endNext, 2 * numEdges, 2 * capacity);
+            edgeCapacity = capacity;
+        }
+        e = numEdges++;
+    }
+    edgeOf->insert(u, v, e);
+    edgeU[e] = u;
+    edgeV[e] = v;
+    edgeLevel[e] = 0;
+    edgeTree[e] = !sameTree(vnode(0, u), vnode(0, v));
+    edgeArc[e] = -1;
+    listEdge(e);
+    if (edgeTree[e]) {
+        linkTreeEdge(e, 0, 0);
+        components--;
+    }
+}
+
+template <class GraphT>
+void BasicDynamicConnectivity<GraphT>::edgeRemoved(int u, int v, int w) {
+    (void)w;
+    int e = edgeOf->find(u, v);
+    if (e == -1) return;    // Not an edge we know of
+    edgeOf->erase(u, v);
+    unlistEdge(e);
+    if (edgeTree[e]) {
+        int arc = edgeArc[e];
+        while (arc != -1) {
+            int reverse = nodes[arc].next;
+            int next = nodes[reverse].next;     // Read before cutTours recycles the arcs
+            cutTours(arc, reverse);
+            arc = next;
+        }
+        components++;
+        if (replace(edgeU[e], edgeV[e], edgeLevel[e])) {
+            components--;
+        }
+    }
+    endNext[2 * e] = freeEdge;
+    freeEdge = e;
+}
+
+template <class GraphT>
+bool BasicDynamicConnectivity<GraphT>::connected(int u, int v) {
+    if (u < 0 || u >= n || v < 0 || v >= n) {
+        throw "Invalid vertex!";
+    }
+    return sameTree(vertexNode[0][u], vertexNode[0][v]);
+}
+
+template <class GraphT>
+int BasicDynamicConnectivity<GraphT>::componentSize(int v) {
+    if (v < 0 || v >= n) {
+        throw "Invalid vertex!";
+    }
+    int x = rootOf(vertexNode[0][v]);
+    return nodes[x].size;
+}
+
+// Explicit instantiations for the graphs that can be observed
+template class BasicDynamicConnectivity<Graph>;
+template class BasicDynamicConnectivity<UnweightedGraph>;
+template class BasicDynamicConnectivity<InterleavedGraph>;
+
+} // namespace graph
@@ -0,0 +1,112 @@
+// michael9090124@gmail.com
+
+#ifndef DYNAMIC_CONNECTIVITY_H
+#define DYNAMIC_CONNECTIVITY_H
+
+#include "Graph.h"
+
+namespace graph {
+
+class EdgeMap;
+
+// Connectivity queries under edge insertions and deletions (Holm, de Lichtenberg and Thorup).
+// The object attaches itself to the graph and follows every addEdge / removeEdge.
+// Every edge has a level in [0, log n]; F_i is a spanning forest of the edges with level
+// >= i, stored as Euler tours in splay trees, and F_0 answers connected(u, v).
+// - insertion: a tree edge of F_0 if it joins two trees, otherwise a level 0 non-tree edge
+// - deleting a non-tree edge only unlists it
+// - deleting a tree edge of level l cuts it from F_0..F_l, then looks for a replacement
+//   from level l down: the level i tree edges of the smaller half move up a level, and so
+//   does every level i non-tree edge scanned without leaving the smaller half. The first
+//   one that leaves it reconnects F_0..F_i
+// A tree of F_i has at most n / 2^i vertices, so an edge moves up at most log n times and
+// updates cost O(log^2 n) amortized; queries cost O(log n) amortized.
+// The graph must outlive this object and must not be moved.
+template <class GraphT>
+class BasicDynamicConnectivity : public GraphObserver {
+private:
+    // Euler tour node: a vertex of F_i (once per vertex and level) or a tree edge arc
+    struct Node {
+        int child[2];
+        int parent;
+        int size;           // Vertex nodes in the subtree (the component size at the root)
+        int vertex;         // -1 for arc nodes
+        int next;           // Arc nodes: arc of the same edge and direction one level up
+        bool hasTree;       // Vertex node whose vertex has tree edges of exactly this level
+        bool hasNonTree;    // Same for non-tree edges
+        bool anyTree;       // Subtree aggregates of the two flags
+        bool anyNonTree;
+    };
+
+    GraphT& g;
+    int n;
+    int levels;
+    int components;
+
+    Node* nodes;
+    int numNodes;
+    int nodeCapacity;
+    int freeNode;           // Free list of arc nodes, linked through next
+
+    int** vertexNode;       // [level][v], -1 until used; levels above 0 are allocated lazily
+    int** treeHead;         // [level][v]: list of v's tree edge ends of exactly this level
+    int** nonTreeHead;      // [level][v]: same for non-tree edges
+
+    EdgeMap* edgeOf;        // Edge id of every edge {u, v}
+    int* edgeU;
+    int* edgeV;
+    int* edgeLevel;
+    bool* edgeTree;
+    int* edgeArc;           // Tree edges: u -> v arc of level 0 (the chain goes up via next)
+    int* endPrev;           // Edge ends 2e (at u) and 2e + 1 (at v) form the vertex lists
+    int* endNext;
+    int numEdges;
+    int edgeCapacity;
+    int freeEdge;           // Free list of edge ids, linked through endNext
+
+    // Euler tour trees
+    int newNode(int vertex);
+    void pull(int x);
+    void rotate(int x);
+    void splay(int x);
+    int rootOf(int x);
+    bool sameTree(int x, int y);
+    int merge(int a, int b);
+    void reroot(int x);
+    void linkTours(int level, int u, int v, int arcUV, int arcVU);
+    void cutTours(int arcA, int arcB);
+    int findFlagged(int x, bool tree);
+
+    // Levels, lists and edges
+    void ensureLevel(int level);
+    int vnode(int level, int v);
+    void updateFlags(int level, int v);
+    void listInsert(int* heads, int end);
+    void listRemove(int* heads, int end);
+    int* headsOf(int e, int level) const { return edgeTree[e] ? treeHead[level] : nonTreeHead[level]; }
+    void unlistEdge(int e);
+    void listEdge(int e);
+    void linkTreeEdge(int e, int fromLevel, int toLevel);
+    bool replace(int u, int v, int level);
+
+public:
+    BasicDynamicConnectivity(GraphT& graph);
+    ~BasicDynamicConnectivity();
+    BasicDynamicConnectivity(const BasicDynamicConnectivity&) = delete;
+    BasicDynamicConnectivity& operator=(const BasicDynamicConnectivity&) = delete;
+
+    // Splay the tours, hence not const
+    bool connected(int u, int v);
+    int componentSize(int v);
+    int numComponents() const { return components; }
+
+    // Called by the graph
+    void edgeAdded(int u, int v, int w) override;
+    void edgeRemoved(int u, int v, int w) override;
+};
+
+using DynamicConnectivity = BasicDynamicConnectivity<Graph>;
+
+}
+
+#endif
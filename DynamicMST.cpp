@@ -0,0 +1,181 @@
+// michael9090124@gmail.com
+
+#include "DynamicMST.h"
+#include "DataStructures.h"
+
+namespace graph {
+
+template <class GraphT>
+BasicDynamicMST<GraphT>::BasicDynamicMST(GraphT& graph) : g(graph), n(graph.getNumVertices()) {
+    lct = new LinkCutTree(2 * n);
+    int slots = n > 0 ? n : 1;      // A forest on n vertices has at most n - 1 edges
+    edgeU = new int[slots];
+    edgeV = new int[slots];
+    edgeW = new int[slots];
+    freeSlots = new int[slots];
+    numFree = n;
+    for (int s = 0; s < n; s++) {
+        edgeU[s] = -1;
+        freeSlots[s] = n - 1 - s;   // Slot 0 is used first
+    }
+    slotOf = new EdgeMap(n);
+    total = 0;
+    side = new int[slots]();
+    queues = new int[2 * slots];
+    lastScanned = 0;
+
+    for (int u = 0; u < n; u++) {
+        for (Edge e : g.edges(u)) {
+            if (u < e.dst) edgeAdded(u, e.dst, e.w);
+        }
+    }
+    g.attach(this);
+}
+
+template <class GraphT>
+BasicDynamicMST<GraphT>::~BasicDynamicMST() {
+    g.detach(this);
+    delete lct;
+    delete[] edgeU;
+    delete[] edgeV;
+    delete[] edgeW;
+    delete[] freeSlots;
+    delete slotOf;
+    delete[] side;
+    delete[] queues;
+}
+
+// --- Forest updates ---
+
+template <class GraphT>
+void BasicDynamicMST<GraphT>::addTreeEdge(int u, int v, int w) {
+    int s = freeSlots[--numFree];
+    edgeU[s] = u;
+    edgeV[s] = v;
+    edgeW[s] = w;
+    lct->setValue(n + s, w);
+    lct->link(u, n + s);
+    lct->link(n + s, v);
+    slotOf->insert(u, v, s);
+    total += w;
+}
+
+template <class GraphT>
+void BasicDynamicMST<GraphT>::removeTreeEdge(int s) {
+    lct->cut(edgeU[s], n + s);
+    lct->cut(n + s, edgeV[s]);
+    slotOf->erase(edgeU[s], edgeV[s]);
+    total -= edgeW[s];
+    edgeU[s] = -1;
+    freeSlots[numFree++] = s;
+}
+
+// u and v were just separated: grow both parts breadth-first over tree edges, one vertex
+// at a time each, until one of them is complete. Its lightest edge to the outside (which
+// can only lead into the other part) is the replacement.
+template <class GraphT>
+bool BasicDynamicMST<GraphT>::findReplacement(int u, int v, int& a, int& b, int& w) {
+    int* queue[2] = {queues, queues + n};
+    int head[2] = {0, 0};
+    int size[2] = {1, 1};
+    queue[0][0] = u;
+    queue[1][0] = v;
+    side[u] = 1;
+    side[v] = 2;
+    int done = -1;
+    while (done == -1) {
+        for (int p = 0; p < 2 && done == -1; p++) {
+            if (head[p] == size[p]) {
+                done = p;
+                break;
+            }
+            int x = queue[p][head[p]++];
+            for (Edge e : g.edges(x)) {
+                if (side[e.dst] == 0 && slotOf->find(x, e.dst) != -1) {
+                    side[e.dst] = p + 1;
+                    queue[p][size[p]++] = e.dst;
+                }
+            }
+        }
+    }
+    lastScanned = head[0] + head[1];
+
+    bool found = false;
+    for (int i = 0; i < size[done]; i++) {
+        int x = queue[done][i];
+        for (Edge e : g.edges(x)) {
+            if (side[e.dst] != done + 1 && (!found || e.w < w)) {
+                found = true;
+                a = x;
+                b = e.dst;
+                w = e.w;
+            }
+        }
+    }
+    for (int p = 0; p < 2; p++) {
+        for (int i = 0; i < size[p]; i++) {
+            side[queue[p][i]] = 0;
+        }
+    }
+    return found;
+}
+
+template <class GraphT>
+void BasicDynamicMST<GraphT>::edgeAdded(int u, int v, int w) {
+    int heaviest = lct->pathMax(u, v);
+    if (heaviest == -1) {           // Different trees
+        addTreeEdge(u, v, w);
+        return;
+    }
+    if (heaviest < n) return;       // No edge node on the path: only possible if u == v
+    int s = heaviest - n;
+    if (edgeW[s] > w) {
+        removeTreeEdge(s);
+        addTreeEdge(u, v, w);
+    }
+}
+
+template <class GraphT>
+void BasicDynamicMST<GraphT>::edgeRemoved(int u, int v, int w) {
+    (void)w;
+    lastScanned = 0;
+    int s = slotOf->find(u, v);
+    if (s == -1) return;            // Not in the forest
+    removeTreeEdge(s);
+    int a, b, weight;
+    if (findReplacement(u, v, a, b, weight)) {
+        addTreeEdge(a, b, weight);
+    }
+}
+
+template <class GraphT>
+bool BasicDynamicMST<GraphT>::inForest(int u, int v) const {
+    if (u < 0 || u >= n || v < 0 || v >= n) {
+        throw "Invalid vertex!";
+    }
+    return u != v && slotOf->find(u, v) != -1;
+}
+
+template <class GraphT>
+bool BasicDynamicMST<GraphT>::connected(int u, int v) {
+    if (u < 0 || u >= n || v < 0 || v >= n) {
+        throw "Invalid vertex!";
+    }
+    return lct->connected(u, v);
+}
+
+template <class GraphT>
+Graph BasicDynamicMST<GraphT>::forest() const {
+    Graph result(n);
+    for (int s = 0; s < n; s++) {
+        if (edgeU[s] != -1) result.addEdge(edgeU[s], edgeV[s], edgeW[s]);
+    }
+    return result;
+}
+
+// Explicit instantiations for the graphs that can be observed
+template class BasicDynamicMST<Graph>;
+template class BasicDynamicMST<UnweightedGraph>;
+template class BasicDynamicMST<InterleavedGraph>;
+
+} // namespace graph
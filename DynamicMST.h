@@ -0,0 +1,68 @@
+// michael9090124@gmail.com
+
+#ifndef DYNAMIC_MST_H
+#define DYNAMIC_MST_H
+
+#include "Graph.h"
+
+namespace graph {
+
+class LinkCutTree;
+class EdgeMap;
+
+// Minimum spanning forest kept up to date while the graph changes.
+// The object attaches itself to the graph and updates the forest after every addEdge /
+// removeEdge. The forest lives in a link-cut tree where every tree edge is a node of its
+// own carrying the edge weight, so the heaviest edge on a tree path is one query:
+// - a new edge between two trees links them; inside a tree it closes a cycle and replaces
+//   the heaviest edge of the cycle if it is lighter, O(log n) amortized
+// - removing a non-tree edge changes nothing; removing a tree edge splits a tree, and the
+//   lightest graph edge leaving the smaller part reconnects it (the smaller part is found
+//   by growing both parts in lockstep, so the search costs the edges of the smaller part)
+// Tree edges are also kept in an EdgeMap for O(1) membership tests.
+// The graph must outlive this object and must not be moved.
+template <class GraphT>
+class BasicDynamicMST : public GraphObserver {
+private:
+    GraphT& g;
+    int n;
+    LinkCutTree* lct;       // Nodes [0, n) are vertices, n + s is the tree edge in slot s
+    int* edgeU;             // Endpoints and weight of the tree edge in each slot
+    int* edgeV;
+    int* edgeW;
+    int* freeSlots;
+    int numFree;
+    EdgeMap* slotOf;        // Slot of every tree edge
+    long long total;
+    int* side;              // Scratch of the replacement search: 0, or the part of a vertex
+    int* queues;            // The two BFS queues, n entries each
+    int lastScanned;        // Vertices the last replacement search expanded
+
+    void addTreeEdge(int u, int v, int w);
+    void removeTreeEdge(int slot);
+    bool findReplacement(int u, int v, int& a, int& b, int& w);
+
+public:
+    BasicDynamicMST(GraphT& graph);
+    ~BasicDynamicMST();
+    BasicDynamicMST(const BasicDynamicMST&) = delete;
+    BasicDynamicMST& operator=(const BasicDynamicMST&) = delete;
+
+    long long totalWeight() const { return total; }
+    int numTreeEdges() const { return n - numFree; }
+    int numComponents() const { return numFree; }    // n vertices, n - c tree edges
+    bool inForest(int u, int v) const;
+    bool connected(int u, int v);       // Splays, hence not const
+    Graph forest() const;               // Same form as prim / kruskal
+    int lastReplacementScan() const { return lastScanned; }
+
+    // Called by the graph
+    void edgeAdded(int u, int v, int w) override;
+    void edgeRemoved(int u, int v, int w) override;
+};
+
+using DynamicMST = BasicDynamicMST<Graph>;
+
+}
+
+#endif
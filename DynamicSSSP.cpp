@@ -0,0 +1,178 @@
+// michael9090124@gmail.com
+
+#include "DynamicSSSP.h"
+#include "Algorithms.h"
+#include "DataStructures.h"
+
+namespace graph {
+
+template <class GraphT>
+BasicDynamicSSSP<GraphT>::BasicDynamicSSSP(GraphT& graph, int start)
+    : g(graph), source(start), n(graph.getNumVertices()) {
+    if (start < 0 || start >= n) {
+        throw "Invalid starting vertex!";
+    }
+    for (int u = 0; u < n; u++) {
+        for (Edge e : g.edges(u)) {
+            if (e.w < 0) {
+                throw "Dijkstra's algorithm does'nt support negative weights!";
+            }
+        }
+    }
+    dist = new int[n];
+    parent = new int[n];
+    affected = new bool[n]();
+    affectedList = new int[n];
+    heap = new IndexedHeap(n);
+    recompute();
+    g.attach(this);     // Last, nothing can throw after it
+}
+
+template <class GraphT>
+BasicDynamicSSSP<GraphT>::~BasicDynamicSSSP() {
+    g.detach(this);
+    delete[] dist;
+    delete[] parent;
+    delete[] affected;
+    delete[] affectedList;
+    delete heap;
+}
+
+template <class GraphT>
+int BasicDynamicSSSP<GraphT>::distance(int v) const {
+    if (v < 0 || v >= n) {
+        throw "Invalid vertex!";
+    }
+    return dist[v];
+}
+
+template <class GraphT>
+int BasicDynamicSSSP<GraphT>::getParent(int v) const {
+    if (v < 0 || v >= n) {
+        throw "Invalid vertex!";
+    }
+    return parent[v];
+}
+
+// Path to v through u if it is shorter than the current one
+template <class GraphT>
+void BasicDynamicSSSP<GraphT>::relaxFrom(int u, int v, int w) {
+    if (dist[u] == DIST_INF) return;
+    long long candidate = (long long)dist[u] + w;
+    if (candidate < dist[v]) {
+        dist[v] = (int)candidate;
+        parent[v] = u;
+        heap->pushOrDecrease(v, dist[v]);
+    }
+}
+
+template <class GraphT>
+void BasicDynamicSSSP<GraphT>::propagate() {
+    while (!heap->isEmpty()) {
+        int u = heap->popMin().vertex;
+        repaired++;
+        for (Edge e : g.edges(u)) {
+            relaxFrom(u, e.dst, e.w);
+        }
+    }
+}
+
+template <class GraphT>
+void BasicDynamicSSSP<GraphT>::recompute() {
+    for (int v = 0; v < n; v++) {
+        dist[v] = DIST_INF;
+        parent[v] = -1;
+    }
+    repaired = 0;
+    dist[source] = 0;
+    heap->pushOrDecrease(source, 0);
+    propagate();
+}
+
+template <class GraphT>
+void BasicDynamicSSSP<GraphT>::validateEdge(int u, int v, int w) {
+    (void)u;
+    (void)v;
+    if (w < 0) {
+        throw "Dijkstra's algorithm does'nt support negative weights!";
+    }
+}
+
+template <class GraphT>
+void BasicDynamicSSSP<GraphT>::edgeAdded(int u, int v, int w) {
+    repaired = 0;
+    // At most one direction improves (w >= 0), and only vertices that get closer are visited
+    relaxFrom(u, v, w);
+    relaxFrom(v, u, w);
+    propagate();
+}
+
+template <class GraphT>
+void BasicDynamicSSSP<GraphT>::edgeRemoved(int u, int v, int w) {
+    (void)w;
+    repaired = 0;
+    int root = parent[v] == u ? v : (parent[u] == v ? u : -1);
+    if (root == -1) return;     // Not a tree edge: every shortest path survives
+
+    // Phase 1: walk the cut-off subtree in order of the old distances. When y is popped,
+    // every vertex closer than y already knows whether it is affected, so a neighbor z
+    // outside the affected set with dist[z] + w == dist[y] (w > 0, so z is not below y)
+    // still offers a shortest path and y keeps its distance, along with its subtree.
+    int count = 0;
+    heap->pushOrDecrease(root, dist[root]);
+    while (!heap->isEmpty()) {
+        int y = heap->popMin().vertex;
+        int alternative = -1;
+        for (Edge e : g.edges(y)) {
+            int z = e.dst;
+            if (e.w > 0 && !affected[z] && dist[z] != DIST_INF && (long long)dist[z] + e.w == dist[y]) {
+                alternative = z;
+                break;
+            }
+        }
+        if (alternative != -1) {
+            parent[y] = alternative;
+            continue;
+        }
+        affected[y] = true;
+        affectedList[count++] = y;
+        for (Edge e : g.edges(y)) {
+            if (parent[e.dst] == y) {
+                heap->pushOrDecrease(e.dst, dist[e.dst]);
+            }
+        }
+    }
+
+    // Phase 2: best distance of every affected vertex through its unaffected neighbors
+    for (int i = 0; i < count; i++) {
+        int y = affectedList[i];
+        dist[y] = DIST_INF;
+        parent[y] = -1;
+    }
+    for (int i = 0; i < count; i++) {
+        int y = affectedList[i];
+        for (Edge e : g.edges(y)) {
+            if (!affected[e.dst]) relaxFrom(e.dst, y, e.w);
+        }
+    }
+
+    // Phase 3: Dijkstra restricted to the affected vertices (the others cannot get closer)
+    while (!heap->isEmpty()) {
+        int y = heap->popMin().vertex;
+        affected[y] = false;    // Settled
+        for (Edge e : g.edges(y)) {
+            if (affected[e.dst]) relaxFrom(y, e.dst, e.w);
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        affected[affectedList[i]] = false;  // Vertices that became unreachable
+    }
+    repaired = count;
+}
+
+// Explicit instantiations for the graphs that can be observed
+template class BasicDynamicSSSP<Graph>;
+template class BasicDynamicSSSP<UnweightedGraph>;
+template class BasicDynamicSSSP<InterleavedGraph>;
+
+} // namespace graph
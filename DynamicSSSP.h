@@ -0,0 +1,63 @@
+// michael9090124@gmail.com
+
+#ifndef DYNAMIC_SSSP_H
+#define DYNAMIC_SSSP_H
+
+#include "Graph.h"
+#include "Algorithms.h"    // DIST_INF
+
+namespace graph {
+
+class IndexedHeap;
+
+// Shortest path distances from a fixed source, kept up to date while the graph changes.
+// The object attaches itself to the graph and repairs its shortest path tree after every
+// addEdge / removeEdge (a weight change is a removeEdge followed by an addEdge):
+// - a new edge that shortens a path starts a Dijkstra search from the improved endpoint,
+//   which only visits vertices whose distance decreases
+// - removing a tree edge cuts off a subtree of the tree. Vertices of the subtree that have
+//   another shortest path through a vertex outside of it just change parent; the others
+//   (the affected vertices) are recomputed by a Dijkstra search restricted to them, seeded
+//   from their unaffected neighbors (Ramalingam-Reps)
+// - removing a non-tree edge changes nothing
+// Weights must be non-negative. The graph must outlive this object and must not be moved.
+template <class GraphT>
+class BasicDynamicSSSP : public GraphObserver {
+private:
+    GraphT& g;
+    int source;
+    int n;
+    int* dist;              // DIST_INF for unreachable vertices
+    int* parent;            // Shortest path tree, -1 for the source and unreachable vertices
+    bool* affected;         // Scratch of a deletion, all false between updates
+    int* affectedList;
+    IndexedHeap* heap;
+    int repaired;           // Vertices whose distance was recomputed by the last update
+
+    void relaxFrom(int u, int v, int w);
+    void propagate();       // Dijkstra from the vertices in heap (distances only decrease)
+
+public:
+    // Throws if source is invalid or the graph has a negative weight
+    BasicDynamicSSSP(GraphT& graph, int source);
+    ~BasicDynamicSSSP();
+    BasicDynamicSSSP(const BasicDynamicSSSP&) = delete;
+    BasicDynamicSSSP& operator=(const BasicDynamicSSSP&) = delete;
+
+    int getSource() const { return source; }
+    int distance(int v) const;      // DIST_INF if v is unreachable
+    int getParent(int v) const;     // -1 for the source and unreachable vertices
+    int lastRepaired() const { return repaired; }
+    void recompute();               // From scratch, O(m log n)
+
+    // Called by the graph. validateEdge rejects negative weights before the graph changes
+    void validateEdge(int u, int v, int w) override;
+    void edgeAdded(int u, int v, int w) override;
+    void edgeRemoved(int u, int v, int w) override;
+};
+
+using DynamicSSSP = BasicDynamicSSSP<Graph>;
+
+}
+
+#endif
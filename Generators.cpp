@@ -0,0 +1,284 @@
+// michael9090124@gmail.com
+
+#include "Generators.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace graph {
+
+// Counter-based random numbers: splitmix64 finalizer of (seed, stream, index)
+static inline unsigned long long mix64(unsigned long long x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+static inline unsigned long long randomAt(unsigned long long seed, unsigned long long stream,
+                                          unsigned long long index) {
+    return mix64(seed ^ mix64(stream * 0x632BE59BD9B4E019ULL + index));
+}
+
+// Uniform double in [0, 1)
+static inline double toUnit(unsigned long long r) {
+    return (double)(r >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static inline int randomWeight(unsigned long long seed, unsigned long long index, int maxWeight) {
+    if (maxWeight <= 1) return 1;
+    return 1 + (int)(randomAt(seed, 7, index) % (unsigned long long)maxWeight);
+}
+
+// Run fn(begin, end) over [0, count): on the shared thread pool for numThreads = 0, otherwise
+// split into equal ranges, one per thread
+template <class Fn>
+static void parallelRange(long long count, int numThreads, Fn fn) {
+    if (numThreads <= 0) {
+        parallel_for(0, count, fn);
+        return;
+    }
+    int threads = numThreads;
+    if (count < 4096) threads = 1; // Not worth a thread
+    std::thread* workers = new std::thread[threads];
+    for (int t = 1; t < threads; t++) {
+        workers[t] = std::thread(fn, count * t / threads, count * (t + 1) / threads);
+    }
+    fn(0LL, count / threads);
+    for (int t = 1; t < threads; t++) {
+        workers[t].join();
+    }
+    delete[] workers;
+}
+
+// Edge arrays filled by the generators and handed to the builder in one call
+struct EdgeArrays {
+    int* src;
+    int* dst;
+    int* w;
+    explicit EdgeArrays(long long m) : src(new int[m > 0 ? m : 1]), dst(new int[m > 0 ? m : 1]), w(new int[m > 0 ? m : 1]) {}
+    ~EdgeArrays() {
+        delete[] src;
+        delete[] dst;
+        delete[] w;
+    }
+};
+
+void generateErdosRenyi(GraphBuilder& builder, int n, long long m, unsigned long long seed,
+                        int maxWeight, int numThreads) {
+    if (n <= 0 || m < 0) {
+        throw "Invalid generator parameters!";
+    }
+    EdgeArrays edges(m);
+    parallelRange(m, numThreads, [&](long long begin, long long end) {
+        for (long long e = begin; e < end; e++) {
+            edges.src[e] = (int)(randomAt(seed, 1, e) % (unsigned long long)n);
+            edges.dst[e] = (int)(randomAt(seed, 2, e) % (unsigned long long)n);
+            edges.w[e] = randomWeight(seed, e, maxWeight);
+        }
+    });
+    builder.setNumVertices(n);
+    builder.appendEdges(edges.src, edges.dst, edges.w, m);
+}
+
+// Bijection on [0, 2^bits) used to scramble R-MAT vertex ids
+struct Scrambler {
+    unsigned long long mask, k1, k2;
+    int shift;
+    Scrambler(int bits, unsigned long long seed)
+        : mask((1ULL << bits) - 1),
+          k1((mix64(seed) | 1) & mask),                 // Odd multipliers are invertible mod 2^bits
+          k2((mix64(seed + 1) | 1) & mask),
+          shift((bits + 1) / 2) {}
+    unsigned long long operator()(unsigned long long x) const {
+        x = (x * k1) & mask;
+        x ^= x >> shift;
+        x = (x * k2) & mask;
+        x ^= x >> shift;
+        return x;
+    }
+};
+
+void generateRMAT(GraphBuilder& builder, int scale, int edgeFactor, unsigned long long seed,
+                  int maxWeight, double a, double b, double c, int numThreads) {
+    if (scale < 1 || scale > 30 || edgeFactor < 1 || a < 0 || b < 0 || c < 0 || a + b + c > 1) {
+        throw "Invalid generator parameters!";
+    }
+    int n = 1 << scale;
+    long long m = (long long)edgeFactor * n;
+    // Quadrant thresholds on 53-bit random integers: a | b | c | d
+    const double unit = 9007199254740992.0;
+    unsigned long long tA = (unsigned long long)(a * unit);
+    unsigned long long tAB = (unsigned long long)((a + b) * unit);
+    unsigned long long tABC = (unsigned long long)((a + b + c) * unit);
+    Scrambler scramble(scale, seed);
+    EdgeArrays edges(m);
+    parallelRange(m, numThreads, [&](long long begin, long long end) {
+        for (long long e = begin; e < end; e++) {
+            unsigned long long u = 0, v = 0;
+            unsigned long long state = randomAt(seed, 6, e); // splitmix64 stream of this edge
+            for (int level = 0; level < scale; level++) {      // Pick a quadrant per bit, branch free
+                state += 0x9E3779B97F4A7C15ULL;
+                unsigned long long r = mix64(state) >> 11;
+                unsigned long long row = r >= tAB;                            // Quadrants c and d
+                unsigned long long col = (r >= tA) ^ (r >= tAB) ^ (r >= tABC); // Quadrants b and d
+                u = (u << 1) | row;
+                v = (v << 1) | col;
+            }
+            edges.src[e] = (int)scramble(u);
+            edges.dst[e] = (int)scramble(v);
+            edges.w[e] = randomWeight(seed, e, maxWeight);
+        }
+    });
+    builder.setNumVertices(n);
+    builder.appendEdges(edges.src, edges.dst, edges.w, m);
+}
+
+void generateGrid(GraphBuilder& builder, int rows, int cols, unsigned long long seed,
+                  int maxWeight, int numThreads) {
+    if (rows <= 0 || cols <= 0 || (long long)rows * cols > 0x7fffffffLL) {
+        throw "Invalid generator parameters!";
+    }
+    long long horizontal = (long long)rows * (cols - 1);
+    long long m = horizontal + (long long)(rows - 1) * cols;
+    EdgeArrays edges(m);
+    parallelRange(m, numThreads, [&](long long begin, long long end) {
+        for (long long e = begin; e < end; e++) {
+            if (e < horizontal) { // (r, c) - (r, c + 1)
+                long long r = e / (cols - 1), c = e % (cols - 1);
+                edges.src[e] = (int)(r * cols + c);
+                edges.dst[e] = (int)(r * cols + c + 1);
+            } else {              // (r, c) - (r + 1, c)
+                long long k = e - horizontal;
+                edges.src[e] = (int)k;
+                edges.dst[e] = (int)(k + cols);
+            }
+            edges.w[e] = randomWeight(seed, e, maxWeight);
+        }
+    });
+    builder.setNumVertices(rows * cols);
+    builder.appendEdges(edges.src, edges.dst, edges.w, m);
+}
+
+void generateBarabasiAlbert(GraphBuilder& builder, int n, int edgesPerVertex, unsigned long long seed,
+                            int maxWeight, int numThreads) {
+    if (n <= 0 || edgesPerVertex <= 0) {
+        throw "Invalid generator parameters!";
+    }
+    long long d = edgesPerVertex;
+    long long m = (long long)n * d;
+    // Endpoint list: position 2e is the source of edge e (vertex e / d), position 2e + 1 its
+    // target, which copies the endpoint at a uniform position in [0, 2e]. Picking a uniform
+    // endpoint is picking a vertex proportionally to its degree.
+    EdgeArrays edges(m);
+    parallelRange(m, numThreads, [&](long long begin, long long end) {
+        for (long long e = begin; e < end; e++) {
+            long long edge = e;
+            long long target;
+            while (true) { // Follow copies until a source position is hit
+                long long pos = (long long)(randomAt(seed, 3, edge) % (unsigned long long)(2 * edge + 1));
+                if (pos % 2 == 0) {
+                    target = (pos / 2) / d;
+                    break;
+                }
+                edge = pos / 2;
+            }
+            edges.src[e] = (int)(e / d);
+            edges.dst[e] = (int)target;
+            edges.w[e] = randomWeight(seed, e, maxWeight);
+        }
+    });
+    builder.setNumVertices(n);
+    builder.appendEdges(edges.src, edges.dst, edges.w, m);
+}
+
+void generateRandomGeometric(GraphBuilder& builder, int n, double radius, unsigned long long seed,
+                             int numThreads) {
+    if (n <= 0 || !(radius > 0)) {         // Also rejects a NaN radius
+        throw "Invalid generator parameters!";
+    }
+    double* x = new double[n];
+    double* y = new double[n];
+    for (int i = 0; i < n; i++) {
+        x[i] = toUnit(randomAt(seed, 4, i));
+        y[i] = toUnit(randomAt(seed, 5, i));
+    }
+
+    // Bucket points into cells of side >= radius (counting sort by cell)
+    // Clamped in double before the conversion: at most about 4n cells, and side^2 fits in an int
+    double cellsPerSide = std::min(1.0 / radius, std::min(std::sqrt(4.0 * n) + 1, 46340.0));
+    int side = cellsPerSide < 1 ? 1 : (int)cellsPerSide;
+    int cells = side * side;
+    auto cellOf = [&](int i) {
+        int cx = (int)(x[i] * side), cy = (int)(y[i] * side);
+        if (cx >= side) cx = side - 1;
+        if (cy >= side) cy = side - 1;
+        return cy * side + cx;
+    };
+    int* cellStart = new int[cells + 1];
+    int* order = new int[n];
+    for (int k = 0; k <= cells; k++) cellStart[k] = 0;
+    for (int i = 0; i < n; i++) cellStart[cellOf(i) + 1]++;
+    for (int k = 0; k < cells; k++) cellStart[k + 1] += cellStart[k];
+    int* fill = new int[cells];
+    for (int k = 0; k < cells; k++) fill[k] = cellStart[k];
+    for (int i = 0; i < n; i++) order[fill[cellOf(i)]++] = i; // Points sorted by id within a cell
+    delete[] fill;
+
+    // Visit the neighbors j > i of point i in the 3x3 surrounding cells
+    double r2 = radius * radius;
+    auto forNeighbors = [&](int i, auto emit) {
+        int cx = cellOf(i) % side, cy = cellOf(i) / side;
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                int nx = cx + dx, ny = cy + dy;
+                if (nx < 0 || ny < 0 || nx >= side || ny >= side) continue;
+                int cell = ny * side + nx;
+                for (int k = cellStart[cell]; k < cellStart[cell + 1]; k++) {
+                    int j = order[k];
+                    if (j <= i) continue;
+                    double ddx = x[i] - x[j], ddy = y[i] - y[j];
+                    double dist2 = ddx * ddx + ddy * ddy;
+                    if (dist2 < r2) emit(j, dist2);
+                }
+            }
+        }
+    };
+
+    // Pass 1: edges per point, pass 2: write them at their prefix-sum position
+    long long* start = new long long[(long long)n + 1];
+    start[0] = 0;
+    parallelRange(n, numThreads, [&](long long begin, long long end) {
+        for (long long i = begin; i < end; i++) {
+            long long count = 0;
+            forNeighbors((int)i, [&](int, double) { count++; });
+            start[i + 1] = count;
+        }
+    });
+    for (int i = 0; i < n; i++) start[i + 1] += start[i];
+    long long m = start[n];
+    EdgeArrays edges(m);
+    parallelRange(n, numThreads, [&](long long begin, long long end) {
+        for (long long i = begin; i < end; i++) {
+            long long pos = start[i];
+            forNeighbors((int)i, [&](int j, double dist2) {
+                int w = (int)(std::sqrt(dist2) * 1000.0 + 0.5);
+                edges.src[pos] = (int)i;
+                edges.dst[pos] = j;
+                edges.w[pos] = w < 1 ? 1 : w;
+                pos++;
+            });
+        }
+    });
+    builder.setNumVertices(n);
+    builder.appendEdges(edges.src, edges.dst, edges.w, m);
+
+    delete[] start;
+    delete[] cellStart;
+    delete[] order;
+    delete[] x;
+    delete[] y;
+}
+
+} // namespace graph
@@ -0,0 +1,47 @@
+// michael9090124@gmail.com
+
+#ifndef GENERATORS_H
+#define GENERATORS_H
+
+#include "GraphBuilder.h"
+
+namespace graph {
+
+// Synthetic graph generators for benchmarking.
+// Every edge is derived from (seed, edge index) with a counter-based random generator, so
+// the output is identical for any thread count. Edges are appended to a GraphBuilder
+// (build a Graph / CSRGraph from it, or write it with CSRGraph::writeFile). Duplicates and
+// self-loops that a random model produces are left for the builder to remove.
+// Weights are uniform in [1, maxWeight] unless stated otherwise. numThreads = 0 runs on the
+// shared thread pool (see setNumThreads), otherwise on numThreads dedicated threads.
+
+// Erdos-Renyi G(n, m): m edges with uniformly random endpoints
+void generateErdosRenyi(GraphBuilder& builder, int n, long long m, unsigned long long seed,
+                        int maxWeight = 1, int numThreads = 0);
+
+// R-MAT / Kronecker: 2^scale vertices, edgeFactor * 2^scale edges, quadrant probabilities
+// a, b, c (d = 1 - a - b - c). Defaults are the Graph500 parameters. Vertex ids are
+// scrambled with a bijective hash so that high degree vertices are not clustered at 0.
+void generateRMAT(GraphBuilder& builder, int scale, int edgeFactor, unsigned long long seed,
+                  int maxWeight = 1, double a = 0.57, double b = 0.19, double c = 0.19,
+                  int numThreads = 0);
+
+// rows x cols 2D grid (4-neighborhood), a simple road-network stand-in
+void generateGrid(GraphBuilder& builder, int rows, int cols, unsigned long long seed,
+                  int maxWeight = 1, int numThreads = 0);
+
+// Barabasi-Albert preferential attachment: vertex v attaches edgesPerVertex edges to
+// endpoints chosen proportionally to degree. Uses the position-sampling formulation
+// (the target of edge e copies a random earlier endpoint), which has no sequential
+// dependency and therefore parallelizes.
+void generateBarabasiAlbert(GraphBuilder& builder, int n, int edgesPerVertex, unsigned long long seed,
+                            int maxWeight = 1, int numThreads = 0);
+
+// Random geometric graph: n points in the unit square, an edge between every pair closer
+// than radius. The weight is the distance scaled by 1000 (at least 1).
+void generateRandomGeometric(GraphBuilder& builder, int n, double radius, unsigned long long seed,
+                             int numThreads = 0);
+
+}
+
+#endif
@@ -1,112 +1,202 @@
 // michael9090124@gmail.com
 
 #include "Graph.h"
-#include <iostream> 
+#include <iostream>
+#include <new>
 
 namespace graph {
 
+    // Allocate a block with room for at least minCapacity edges and a reference count of 1
+    template <class WeightPolicy>
+    int* BasicGraph<WeightPolicy>::allocBlock(int minCapacity) {
+        int ints = SlabArena::roundUp(BLOCK_HEADER + minCapacity * SLOTS);
+        int* block = arena->allocate(ints);
+        block[0] = 1;
+        block[1] = (ints - BLOCK_HEADER) / SLOTS; // Use the whole size class as capacity
+        return block;
+    }
+
+    // Drop one reference to a block, returning it to the arena when nobody uses it anymore
+    template <class WeightPolicy>
+    void BasicGraph<WeightPolicy>::releaseBlock(int* block) {
+        if (block != nullptr && --block[0] == 0) {
+            arena->deallocate(block, BLOCK_HEADER + block[1] * SLOTS);
+        }
+    }
+
+    // Chunk of vertex v, cloned first if it is shared with other graphs
+    template <class WeightPolicy>
+    typename BasicGraph<WeightPolicy>::Chunk* BasicGraph<WeightPolicy>::uniqueChunk(int v) {
+        int c = v >> CHUNK_BITS;
+        Chunk* chunk = chunks[c];
+        if (chunk->refs > 1) { // Copy-on-write: clone the chunk, keep sharing its blocks
+            Chunk* clone = new (arena->allocate(CHUNK_INTS)) Chunk;
+            clone->refs = 1;
+            for (int i = 0; i < CHUNK_SIZE; i++) {
+                clone->lists[i] = chunk->lists[i];
+                clone->sizes[i] = chunk->sizes[i];
+                if (clone->lists[i] != nullptr) clone->lists[i][0]++;
+            }
+            chunk->refs--;
+            chunks[c] = clone;
+            chunk = clone;
+        }
+        return chunk;
+    }
+
+    // Share all chunks of other (this must hold no storage)
+    template <class WeightPolicy>
+    void BasicGraph<WeightPolicy>::shareFrom(const BasicGraph& other) {
+        numVertices = other.numVertices;
+        numChunks = other.numChunks;
+        arena = other.arena;
+        if (arena != nullptr) arena->addOwner();
+        chunks = new Chunk*[numChunks];
+        for (int c = 0; c < numChunks; c++) {
+            chunks[c] = other.chunks[c];
+            chunks[c]->refs++;
+        }
+    }
+
+    // Drop all storage references held by this graph
+    template <class WeightPolicy>
+    void BasicGraph<WeightPolicy>::release() {
+        if (arena != nullptr && arena->removeOwner() == 0) {
+            // Every chunk and block we reference lives in the arena: free it in bulk
+            delete arena;
+        }
+        else {
+            for (int c = 0; c < numChunks; c++) {
+                Chunk* chunk = chunks[c];
+                if (--chunk->refs == 0) { // Last owner frees the chunk and its blocks
+                    for (int i = 0; i < CHUNK_SIZE; i++) {
+                        releaseBlock(chunk->lists[i]);
+                    }
+                    arena->deallocate(reinterpret_cast<int*>(chunk), CHUNK_INTS);
+                }
+            }
+        }
+        delete[] chunks;
+        chunks = nullptr;
+        arena = nullptr;
+        numChunks = 0;
+        numVertices = 0;
+    }
+
     // Check for direct neighbor (u -> v)
-    bool Graph::isDirectNeighbor(int u, int v) const {
+    template <class WeightPolicy>
+    bool BasicGraph<WeightPolicy>::isDirectNeighbor(int u, int v) const {
         if (u < 0 || u >= numVertices || v < 0 || v >= numVertices) {
             return false; // Invalid index
         }
-        for (int i = 0; i < sizes[u]; i++) {
-            if (adjList[u][i] == v) return true;   // Found v in u's neighbor list
+        int* list = listOf(u);
+        for (int i = 0; i < sizeOf(u); i++) {
+            if (list[nbrSlot(i)] == v) return true;   // Found v in u's neighbor list
         }
         return false; // v not found in u's list
     }
 
-    Graph::Graph(int vertices) : numVertices(vertices) { // Constructor
+    template <class WeightPolicy>
+    BasicGraph<WeightPolicy>::BasicGraph(int vertices) : numVertices(vertices) { // Constructor
         if (vertices < 0) { // Check for negative number of vertices
             throw "Number of vertices cannot be negative!";
         }
-        adjList = new int *[numVertices];   // Adjacency lists
-        weights = new int *[numVertices];   // Corresponding weights
-        sizes = new int[numVertices];    // Size of each adjacency list
+        arena = new SlabArena();
+        numChunks = (numVertices + CHUNK_SIZE - 1) >> CHUNK_BITS;
+        chunks = new Chunk*[numChunks];
 
         // Initialize lists and sizes
-        for (int i = 0; i < numVertices; i++) {
-            adjList[i] = nullptr;
-            weights[i] = nullptr;
-            sizes[i] = 0;
+        for (int c = 0; c < numChunks; c++) {
+            chunks[c] = new (arena->allocate(CHUNK_INTS)) Chunk;
+            chunks[c]->refs = 1;
+            for (int i = 0; i < CHUNK_SIZE; i++) {
+                chunks[c]->lists[i] = nullptr;
+                chunks[c]->sizes[i] = 0;
+            }
         }
     }
 
-    Graph::Graph(const Graph &other) : numVertices(other.numVertices) { // Copy constructor
-        adjList = new int *[numVertices];
-        weights = new int *[numVertices];
-        sizes = new int[numVertices];
-
-        for (int i = 0; i < numVertices; i++) {
-            sizes[i] = other.sizes[i];
-            if (sizes[i] > 0) { // If adjacency list is not empty, allocate memory
-                adjList[i] = new int[sizes[i]];
-                weights[i] = new int[sizes[i]];
-                for (int j = 0; j < sizes[i]; j++) {
-                    adjList[i][j] = other.adjList[i][j];
-                    weights[i][j] = other.weights[i][j];
+    template <class WeightPolicy>
+    BasicGraph<WeightPolicy>::BasicGraph(int vertices, const long long* offsets, const int* neighbors,
+                                         const int* weights)
+        : BasicGraph(vertices) { // Bulk constructor
+        for (int v = 0; v < numVertices; v++) {
+            int size = (int)(offsets[v + 1] - offsets[v]);
+            if (size == 0) continue;
+            int* list = allocBlock(size); // Exact size class, no regrowth
+            const int* nbr = neighbors + offsets[v];
+            for (int i = 0; i < size; i++) {
+                list[nbrSlot(i)] = nbr[i];
+                if (WeightPolicy::hasWeights) {
+                    list[wSlot(list, i)] = weights ? weights[offsets[v] + i] : 1;
                 }
             }
-            else {
-                adjList[i] = nullptr;
-                weights[i] = nullptr;
-            }
+            chunks[v >> CHUNK_BITS]->lists[v & CHUNK_MASK] = list;
+            chunks[v >> CHUNK_BITS]->sizes[v & CHUNK_MASK] = size;
         }
     }
 
-    Graph& Graph::operator=(const Graph& other) {    // Assignment operator
+    template <class WeightPolicy>
+    BasicGraph<WeightPolicy>::BasicGraph(const BasicGraph &other) { // Copy constructor
+        shareFrom(other); // Lists are duplicated lazily on mutation
+    }
+
+    template <class WeightPolicy>
+    BasicGraph<WeightPolicy>& BasicGraph<WeightPolicy>::operator=(const BasicGraph& other) {    // Assignment operator
         if (this == &other) {   // Check for self-assignment
             return *this;   // Return current object if self-assigning
         }
-        // Delete existing resources
-        for (int i = 0; i < numVertices; i++) {
-            if (sizes[i] > 0) {
-                delete[] adjList[i];
-                delete[] weights[i];
-            }
+        if (observers != nullptr) {
+            throw "Cannot assign to a graph with attached observers!";
         }
-        delete[] adjList;
-        delete[] weights;
-        delete[] sizes;
+        release();          // Drop existing storage
+        shareFrom(other);   // Share other's storage
+        return *this;
+    }
 
-        // Copy data from other graph
-        numVertices = other.numVertices;
-        adjList = new int *[numVertices];
-        weights = new int *[numVertices];
-        sizes = new int[numVertices];
+    template <class WeightPolicy>
+    BasicGraph<WeightPolicy>::BasicGraph(BasicGraph&& other) noexcept // Move constructor
+        : numVertices(other.numVertices), numChunks(other.numChunks), chunks(other.chunks), arena(other.arena) {
+        // Leave other as a valid empty graph
+        other.numVertices = 0;
+        other.numChunks = 0;
+        other.chunks = nullptr;
+        other.arena = nullptr;
+    }
 
-        for (int i = 0; i < numVertices; i++) {
-            sizes[i] = other.sizes[i];
-            if (sizes[i] > 0) {
-                adjList[i] = new int[sizes[i]];
-                weights[i] = new int[sizes[i]];
-                for (int j = 0; j < sizes[i]; j++) {
-                    adjList[i][j] = other.adjList[i][j];
-                    weights[i][j] = other.weights[i][j];
-                }
-            }
-            else {
-                adjList[i] = nullptr;
-                weights[i] = nullptr;
-            }
+    template <class WeightPolicy>
+    BasicGraph<WeightPolicy>& BasicGraph<WeightPolicy>::operator=(BasicGraph&& other) { // Move assignment
+        if (this == &other) {
+            return *this;
+        }
+        if (observers != nullptr || other.observers != nullptr) { // other receives our storage
+            throw "Cannot assign to a graph with attached observers!";
         }
+        // Swap with other, its destructor releases our old storage
+        int tmpVertices = numVertices;
+        int tmpChunks = numChunks;
+        Chunk** tmpChunkList = chunks;
+        SlabArena* tmpArena = arena;
+        numVertices = other.numVertices;
+        numChunks = other.numChunks;
+        chunks = other.chunks;
+        arena = other.arena;
+        other.numVertices = tmpVertices;
+        other.numChunks = tmpChunks;
+        other.chunks = tmpChunkList;
+        other.arena = tmpArena;
         return *this;
     }
 
-    Graph::~Graph() { // Destructor
-        for (int i = 0; i < numVertices; i++) {
-            if (sizes[i] > 0) { // Check if the list for vertex i has allocated memory
-                delete[] adjList[i];
-                delete[] weights[i];
-            }
-        }
-        delete[] adjList;
-        delete[] weights;
-        delete[] sizes;
+    template <class WeightPolicy>
+    BasicGraph<WeightPolicy>::~BasicGraph() { // Destructor
+        release();
     }
 
     // Add an edge to the graph
-    void Graph::addEdge(int src, int dest, int weight) {
+    // For Unweighted graphs the weight argument is ignored (every edge weighs 1)
+    template <class WeightPolicy>
+    void BasicGraph<WeightPolicy>::addEdge(int src, int dest, int weight) {
         if (src < 0 || src >= numVertices || dest < 0 || dest >= numVertices) {
              throw "Invalid vertex!";
         }
@@ -115,41 +205,57 @@ namespace graph {
         }
 
         if (isDirectNeighbor(src, dest)) return; // Check if edge already exists
-
-        // Reallocate and copy for src -> dest
-        int newSzSrc = sizes[src] + 1;
-        int* newAdjSrc= new int[newSzSrc];
-        int* newWeSrc = new int[newSzSrc];
-        for (int i = 0; i < sizes[src]; i++) {
-            newAdjSrc[i] = adjList[src][i];
-            newWeSrc[i] = weights[src][i];
+        if (!isDirectNeighbor(dest, src)) { // Outer call: observers may still reject the edge
+            for (GraphObserver* o = observers; o != nullptr; o = o->nextObserver) {
+                o->validateEdge(src, dest, WeightPolicy::hasWeights ? weight : 1);
+            }
         }
-        newAdjSrc[sizes[src]] = dest; // Add the new neighbor
-        newWeSrc[sizes[src]] = weight;
 
-        if (sizes[src] > 0) { // Free old arrays if they existed
-            delete[] adjList[src];
-            delete[] weights[src];
+        Chunk* chunk = uniqueChunk(src);
+        int slot = src & CHUNK_MASK;
+        int* list = chunk->lists[slot];
+        int size = chunk->sizes[slot];
+
+        // Grow into a new block if the list is full or shared with a copy
+        if (list == nullptr || list[0] > 1 || size == list[1]) {
+            int* newList = allocBlock(size + 1); // Next size class, capacity doubles
+            for (int i = 0; i < size; i++) {
+                newList[nbrSlot(i)] = list[nbrSlot(i)];
+                if (WeightPolicy::hasWeights) {
+                    newList[wSlot(newList, i)] = list[wSlot(list, i)];
+                }
+            }
+            releaseBlock(list);
+            chunk->lists[slot] = newList;
+            list = newList;
+        }
+        list[nbrSlot(size)] = dest; // Add the new neighbor in place
+        if (WeightPolicy::hasWeights) {
+            list[wSlot(list, size)] = weight;
         }
-        adjList[src] = newAdjSrc;   // Update pointers
-        weights[src] = newWeSrc;
-        sizes[src] = newSzSrc;     // Update size
+        chunk->sizes[slot] = size + 1;
 
         // Since graph is assumed undirected, add the edge in the other direction too
         // Note: Recursive call might lead to stack overflow for large graphs/sequences.
         // An iterative approach or checking existence before calling addEdge might be safer.
         if (!isDirectNeighbor(dest, src)) { // Avoid infinite recursion if somehow called improperly
              addEdge(dest, src, weight); // Add edge dest -> src
+             // Only the outer call gets here, once both directions exist
+             for (GraphObserver* o = observers; o != nullptr; o = o->nextObserver) {
+                 o->edgeAdded(src, dest, WeightPolicy::hasWeights ? weight : 1);
+             }
         }
     }
 
-    void Graph::removeEdge(int src, int dest) { // Remove an edge from the graph
+    template <class WeightPolicy>
+    void BasicGraph<WeightPolicy>::removeEdge(int src, int dest) { // Remove an edge from the graph
         if (src < 0 || src >= numVertices || dest < 0 || dest >= numVertices) {
             throw "Invalid vertex!";
         }
+        int originalSize = sizeOf(src);
         int index_src = -1; // Index of dest in src's list
-        for (int i = 0; i < sizes[src]; i++) {
-            if (adjList[src][i] == dest) {
+        for (int i = 0; i < originalSize; i++) {
+            if (listOf(src)[nbrSlot(i)] == dest) {
                 index_src = i;
                 break;
             }
@@ -157,50 +263,84 @@ namespace graph {
         if (index_src == -1) { // If edge src->dest doesn't exist
             throw "Edge does not exist!";
         }
+        int weight = weightAt(src, index_src); // Reported to the observers
 
         // Remove dest from src's list
         { // Scope for temporary variables for src->dest removal
-            int originalSize = sizes[src];
+            Chunk* chunk = uniqueChunk(src);
+            int slot = src & CHUNK_MASK;
+            int* list = chunk->lists[slot];
             int newSize = originalSize - 1;
-            int* newAdj = nullptr;
-            int* newWeights = nullptr;
 
-            if (newSize > 0) { // Create smaller arrays if the list won't be empty
-                newAdj = new int[newSize];
-                newWeights = new int[newSize];
+            if (newSize == 0) { // Empty list: give the block back
+                releaseBlock(list);
+                chunk->lists[slot] = nullptr;
+            }
+            else if (list[0] > 1) { // Shared with a copy: build a private smaller block
+                int* newList = allocBlock(newSize);
                 // Copy elements, skipping the one at index_src
                 for (int i = 0, j = 0; i < originalSize; i++) {
                     if (i != index_src) {
-                        newAdj[j] = adjList[src][i];
-                        newWeights[j] = weights[src][i];
+                        newList[nbrSlot(j)] = list[nbrSlot(i)];
+                        if (WeightPolicy::hasWeights) {
+                            newList[wSlot(newList, j)] = list[wSlot(list, i)];
+                        }
                         j++;
                     }
                 }
+                releaseBlock(list);
+                chunk->lists[slot] = newList;
+            }
+            else { // Private block: shift the tail down in place (keeps neighbor order)
+                for (int i = index_src; i < newSize; i++) {
+                    list[nbrSlot(i)] = list[nbrSlot(i + 1)];
+                    if (WeightPolicy::hasWeights) {
+                        list[wSlot(list, i)] = list[wSlot(list, i + 1)];
+                    }
+                }
             }
-            // Free old arrays for src
-            delete[] adjList[src];
-            delete[] weights[src];
-
-            // Update src's pointers and size
-            adjList[src] = newAdj;
-            weights[src] = newWeights;
-            sizes[src] = newSize;
+            chunk->sizes[slot] = newSize;
         } // End of temporary scope
 
         // Check if the reverse edge (dest->src) still exists and remove it recursively if needed
         // Note: Potential for stack overflow with recursive calls for large graphs.
         if (isDirectNeighbor(dest, src)) {
             removeEdge(dest, src); // Remove edge dest -> src
+            // Only the outer call gets here, once both directions are gone
+            for (GraphObserver* o = observers; o != nullptr; o = o->nextObserver) {
+                o->edgeRemoved(src, dest, weight);
+            }
+        }
+    }
+
+    template <class WeightPolicy>
+    void BasicGraph<WeightPolicy>::attach(GraphObserver* observer) {
+        for (GraphObserver* o = observers; o != nullptr; o = o->nextObserver) {
+            if (o == observer) return; // Already attached
+        }
+        observer->nextObserver = observers;
+        observers = observer;
+    }
+
+    template <class WeightPolicy>
+    void BasicGraph<WeightPolicy>::detach(GraphObserver* observer) {
+        for (GraphObserver** link = &observers; *link != nullptr; link = &(*link)->nextObserver) {
+            if (*link == observer) {
+                *link = observer->nextObserver;
+                observer->nextObserver = nullptr;
+                return;
+            }
         }
     }
 
     // Print the graph representation
-    void Graph::print_graph() {
+    template <class WeightPolicy>
+    void BasicGraph<WeightPolicy>::print_graph() const {
         for (int i = 0; i < numVertices; i++) {
             std::cout << "Vertex " << i << ": {";
-            for (int j = 0; j < sizes[i]; j++) {
-                std::cout << adjList[i][j] << " (" << weights[i][j] << ")";
-                if (j < sizes[i] - 1) {
+            for (int j = 0; j < sizeOf(i); j++) {
+                std::cout << neighborAt(i, j) << " (" << weightAt(i, j) << ")";
+                if (j < sizeOf(i) - 1) {
                     std::cout << ",  ";
                 }
             }
@@ -209,28 +349,48 @@ namespace graph {
     }
 
     // Getters
-    int Graph::getNumVertices() const {
+    template <class WeightPolicy>
+    int BasicGraph<WeightPolicy>::getNumVertices() const {
         return numVertices;
     }
 
-    int Graph::getSize(int v) const { // Number of neighbors for vertex v
+    template <class WeightPolicy>
+    int BasicGraph<WeightPolicy>::getSize(int v) const { // Number of neighbors for vertex v
         if (v < 0 || v >= numVertices) {
             throw "Invalid vertex!";
         }
-        return sizes[v];
+        return sizeOf(v);
     }
 
-    int* Graph::getAdjList(int v) const { // Adjacency list for vertex v
+    template <class WeightPolicy>
+    const int* BasicGraph<WeightPolicy>::getAdjList(int v) const { // Adjacency list for vertex v
         if (v < 0 || v >= numVertices) {
             throw "Invalid vertex!";
         }
-        return adjList[v];
+        int* list = listOf(v);
+        if (list == nullptr || WeightPolicy::interleaved) return nullptr; // No plain neighbor array
+        return list + BLOCK_HEADER;
     }
 
-    int* Graph::getWeights(int v) const { // Weights list for vertex v
+    template <class WeightPolicy>
+    const int* BasicGraph<WeightPolicy>::getWeights(int v) const { // Weights list for vertex v
         if (v < 0 || v >= numVertices) {
             throw "Invalid vertex!";
         }
-        return weights[v];
+        if (!WeightPolicy::hasWeights || WeightPolicy::interleaved) return nullptr; // No plain weights array
+        int* list = listOf(v);
+        if (list == nullptr) return nullptr;
+        return list + BLOCK_HEADER + list[1];
     }
+
+    template <class WeightPolicy>
+    long long BasicGraph<WeightPolicy>::bytesReserved() const {
+        if (arena == nullptr) return 0;
+        return arena->bytesReserved();
+    }
+
+    // Explicit instantiations for the supported storage policies
+    template class BasicGraph<Weighted>;
+    template class BasicGraph<Unweighted>;
+    template class BasicGraph<Interleaved>;
 } // namespace graph
@@ -3,34 +3,186 @@
 #ifndef GRAPH_H
 #define GRAPH_H
 
+#include "DataStructures.h"
+
 namespace graph {
 
-class Graph {
+// Edge storage policies (chosen at compile time)
+struct Weighted {           // Parallel arrays: all neighbors of a vertex, then all weights
+    static constexpr bool hasWeights = true;
+    static constexpr bool interleaved = false;
+};
+
+struct Unweighted {         // No weights array, every edge has implicit weight 1
+    static constexpr bool hasWeights = false;
+    static constexpr bool interleaved = false;
+};
+
+struct Interleaved {        // Array of {neighbor, weight} records, one cache line serves both
+    static constexpr bool hasWeights = true;
+    static constexpr bool interleaved = true;
+};
+
+// A single edge as seen by the algorithms
+struct Edge {
+    int dst;
+    int w;
+};
+
+// Receives the mutations of a graph it is attached to (BasicGraph::attach), e.g. to keep
+// derived results up to date. Called once per undirected edge, after both directions
+// have been updated; the weight is the one stored (1 for Unweighted graphs).
+// edgeAdded / edgeRemoved must not throw: the graph has already changed. An observer that
+// can't take an edge rejects it in validateEdge, which runs before addEdge changes anything.
+class GraphObserver {
 private:
+    GraphObserver* nextObserver = nullptr;  // Intrusive list of the observed graph
+    template <class WeightPolicy> friend class BasicGraph;
+
+public:
+    virtual ~GraphObserver() {}
+    virtual void validateEdge(int u, int v, int w) { (void)u; (void)v; (void)w; }
+    virtual void edgeAdded(int u, int v, int w) = 0;
+    virtual void edgeRemoved(int u, int v, int w) = 0;
+};
+
+// Adjacency storage is copy-on-write:
+// - vertices are grouped into chunks of CHUNK_SIZE, a chunk is shared between copies
+//   and cloned (pointers only) the first time a copy mutates one of its vertices
+// - each vertex list lives in a reference-counted block, so a cloned chunk still shares
+//   the lists of all vertices that were not mutated
+// Copying a graph is O(V / CHUNK_SIZE). Graphs that share storage must not be mutated
+// from different threads at the same time (reference counts are not atomic).
+// Chunks and blocks come from a SlabArena shared by all copies of a graph. Blocks have
+// power-of-two sizes with spare capacity, so most edge insertions append in place, and
+// the last graph using the arena frees everything with a few bulk frees.
+template <class WeightPolicy>
+class BasicGraph {
+private:
+    static const int CHUNK_BITS = 6;
+    static const int CHUNK_SIZE = 1 << CHUNK_BITS;
+    static const int CHUNK_MASK = CHUNK_SIZE - 1;
+    static const int BLOCK_HEADER = 2;  // block[0] = reference count, block[1] = capacity
+    static const int SLOTS = WeightPolicy::hasWeights ? 2 : 1; // ints per edge
+    static const int STRIDE = WeightPolicy::interleaved ? 2 : 1; // distance between neighbors
+
+    // Block layout: [refcount][capacity] followed by
+    //   Weighted:    [neighbors x capacity][weights x capacity]
+    //   Unweighted:  [neighbors x capacity]
+    //   Interleaved: [neighbor, weight] x capacity
+    struct Chunk {
+        int refs;                   // Number of graphs sharing this chunk
+        int* lists[CHUNK_SIZE];     // Block of each vertex (nullptr if no neighbors)
+        int sizes[CHUNK_SIZE];      // Number of neighbors of each vertex
+    };
+    static const int CHUNK_INTS = (int)(sizeof(Chunk) / sizeof(int)) + 1; // Arena size of a chunk
+
     int numVertices;
-    int** adjList;
-    int** weights;
-    int* sizes;
+    int numChunks;
+    Chunk** chunks;
+    SlabArena* arena;
+    GraphObserver* observers = nullptr; // Belong to this object: not copied, not moved
+
     bool isDirectNeighbor(int u, int v) const;
+    int* listOf(int v) const { return chunks[v >> CHUNK_BITS]->lists[v & CHUNK_MASK]; }
+    int sizeOf(int v) const { return chunks[v >> CHUNK_BITS]->sizes[v & CHUNK_MASK]; }
+    // Offsets of the i-th neighbor / weight inside a block
+    static int nbrSlot(int i) { return BLOCK_HEADER + i * STRIDE; }
+    static int wSlot(const int* list, int i) {
+        if (WeightPolicy::interleaved) return BLOCK_HEADER + 2 * i + 1;
+        return BLOCK_HEADER + list[1] + i;
+    }
+    Chunk* uniqueChunk(int v);
+    void shareFrom(const BasicGraph& other);
+    void release();
+
+    int* allocBlock(int minCapacity);
+    void releaseBlock(int* block);
 
 public:
-    Graph(int vertices);
-    Graph(const Graph& other);
-    Graph& operator=(const Graph& other);
-    ~Graph();
+    BasicGraph(int vertices);
+    // Bulk load: neighbors of v are neighbors[offsets[v] .. offsets[v+1]) (weights may be nullptr).
+    // The arrays must describe a simple undirected graph (mirrored arcs, no loops or duplicates).
+    BasicGraph(int vertices, const long long* offsets, const int* neighbors, const int* weights);
+    BasicGraph(const BasicGraph& other);                // O(V / CHUNK_SIZE), shares storage
+    BasicGraph& operator=(const BasicGraph& other);
+    BasicGraph(BasicGraph&& other) noexcept;            // O(1), leaves other empty
+    BasicGraph& operator=(BasicGraph&& other);          // Throws if either graph has observers
+    ~BasicGraph();
 
     void addEdge(int src, int dest, int weight = 1);
     void removeEdge(int src, int dest);
-    void print_graph();
-    
+    void print_graph() const;
+
+    // Observers are notified of every successful addEdge / removeEdge on this object.
+    // An observer can watch one graph at a time and must be detached before it is destroyed.
+    // Assigning to a graph that has observers throws (their state is sized for its vertices).
+    void attach(GraphObserver* observer);
+    void detach(GraphObserver* observer);
+
 
 
     int getNumVertices() const;
     int getSize(int v) const;
-    int* getAdjList(int v) const;
-    int* getWeights(int v) const;
+    const int* getAdjList(int v) const;  // Read-only view, may be shared with copies (nullptr for Interleaved)
+    const int* getWeights(int v) const;  // nullptr for Unweighted and Interleaved graphs
+    long long bytesReserved() const; // Memory held by the storage arena
+
+    // Unchecked accessors for the i-th edge of v
+    int neighborAt(int v, int i) const { return listOf(v)[nbrSlot(i)]; }
+    int weightAt(int v, int i) const {
+        if (WeightPolicy::hasWeights) {
+            const int* list = listOf(v);
+            return list[wSlot(list, i)];
+        }
+        return 1;           // Implicit weight
+    }
+
+    // Edge iteration independent of the layout: for (Edge e : g.edges(v)) { ... }
+    class EdgeIterator {
+    private:
+        const int* nbr;     // Current neighbor
+        const int* wt;      // Current weight (unused for Unweighted)
+    public:
+        EdgeIterator(const int* n, const int* w) : nbr(n), wt(w) {}
+        Edge operator*() const {
+            Edge e;
+            e.dst = *nbr;
+            e.w = WeightPolicy::hasWeights ? *wt : 1;
+            return e;
+        }
+        EdgeIterator& operator++() {
+            nbr += STRIDE;
+            if (WeightPolicy::hasWeights) wt += STRIDE;
+            return *this;
+        }
+        bool operator!=(const EdgeIterator& other) const { return nbr != other.nbr; }
+    };
+
+    class EdgeRange {
+    private:
+        EdgeIterator first;
+        EdgeIterator last;
+    public:
+        EdgeRange(EdgeIterator f, EdgeIterator l) : first(f), last(l) {}
+        EdgeIterator begin() const { return first; }
+        EdgeIterator end() const { return last; }
+    };
+
+    EdgeRange edges(int v) const { // Unchecked, v must be a valid vertex
+        const int* list = listOf(v);
+        if (list == nullptr) return EdgeRange(EdgeIterator(nullptr, nullptr), EdgeIterator(nullptr, nullptr));
+        int size = sizeOf(v);
+        const int* w = WeightPolicy::hasWeights ? list + wSlot(list, 0) : nullptr;
+        return EdgeRange(EdgeIterator(list + nbrSlot(0), w),
+                         EdgeIterator(list + nbrSlot(size), nullptr));
+    }
 };
 
+using Graph = BasicGraph<Weighted>;
+using UnweightedGraph = BasicGraph<Unweighted>;
+using InterleavedGraph = BasicGraph<Interleaved>;
+
 }
 
 #endif
@@ -0,0 +1,192 @@
+// michael9090124@gmail.com
+
+#include "GraphBuilder.h"
+#include <cstring>
+
+namespace graph {
+
+GraphBuilder::GraphBuilder(int vertices)
+    : numVertices(0), numEdges(0), capacity(0), srcs(nullptr), dsts(nullptr), wts(nullptr) {
+    setNumVertices(vertices);
+}
+
+GraphBuilder::~GraphBuilder() {
+    delete[] srcs;
+    delete[] dsts;
+    delete[] wts;
+}
+
+// Grow the edge arrays (capacity doubles)
+void GraphBuilder::grow(long long minCapacity) {
+    if (minCapacity <= capacity) return;
+    long long newCapacity = capacity == 0 ? 1024 : capacity * 2;
+    if (newCapacity < minCapacity) newCapacity = minCapacity;
+    int* newSrcs = new int[newCapacity];
+    int* newDsts = new int[newCapacity];
+    int* newWts = new int[newCapacity];
+    if (numEdges > 0) {
+        std::memcpy(newSrcs, srcs, numEdges * sizeof(int));
+        std::memcpy(newDsts, dsts, numEdges * sizeof(int));
+        std::memcpy(newWts, wts, numEdges * sizeof(int));
+    }
+    delete[] srcs;
+    delete[] dsts;
+    delete[] wts;
+    srcs = newSrcs;
+    dsts = newDsts;
+    wts = newWts;
+    capacity = newCapacity;
+}
+
+void GraphBuilder::setNumVertices(int vertices) {
+    if (vertices < 0) {
+        throw "Number of vertices cannot be negative!";
+    }
+    if (vertices > numVertices) numVertices = vertices;
+}
+
+void GraphBuilder::reserve(long long edges) {
+    grow(edges);
+}
+
+void GraphBuilder::addEdge(int src, int dest, int weight) {
+    appendEdges(&src, &dest, &weight, 1);
+}
+
+void GraphBuilder::appendEdges(const int* src, const int* dest, const int* weight, long long count) {
+    if (count <= 0) return;
+    int maxId = -1;
+    for (long long i = 0; i < count; i++) { // Validate ids and track the vertex count
+        if (src[i] < 0 || dest[i] < 0) {
+            throw "Invalid vertex!";
+        }
+        if (src[i] > maxId) maxId = src[i];
+        if (dest[i] > maxId) maxId = dest[i];
+    }
+    grow(numEdges + count);
+    std::memcpy(srcs + numEdges, src, count * sizeof(int));
+    std::memcpy(dsts + numEdges, dest, count * sizeof(int));
+    if (weight != nullptr) {
+        std::memcpy(wts + numEdges, weight, count * sizeof(int));
+    } else {
+        for (long long i = 0; i < count; i++) {
+            wts[numEdges + i] = 1;
+        }
+    }
+    numEdges += count;
+    if (maxId + 1 > numVertices) numVertices = maxId + 1;
+}
+
+void GraphBuilder::clear() {
+    numEdges = 0;
+    numVertices = 0;
+}
+
+int GraphBuilder::getNumVertices() const {
+    return numVertices;
+}
+
+long long GraphBuilder::getNumEdges() const {
+    return numEdges;
+}
+
+void GraphBuilder::toCSRArrays(bool symmetric, long long*& offsets, int*& neighbors, int*& weights,
+                               long long& arcCount) const {
+    int n = numVertices;
+
+    // Pass 1: stable counting sort of all arcs by destination
+    long long* count = new long long[n + 1];
+    for (int v = 0; v <= n; v++) count[v] = 0;
+    for (long long i = 0; i < numEdges; i++) {
+        if (srcs[i] == dsts[i]) continue; // Self-loops are dropped
+        count[dsts[i] + 1]++;
+        if (symmetric) count[srcs[i] + 1]++;
+    }
+    for (int v = 0; v < n; v++) count[v + 1] += count[v];
+    long long arcs = count[n];
+    int* bySrc = new int[arcs > 0 ? arcs : 1];   // Arcs sorted by destination
+    int* byDst = new int[arcs > 0 ? arcs : 1];
+    int* byW = new int[arcs > 0 ? arcs : 1];
+    for (long long i = 0; i < numEdges; i++) {
+        int u = srcs[i], v = dsts[i];
+        if (u == v) continue;
+        long long p = count[v]++;
+        bySrc[p] = u; byDst[p] = v; byW[p] = wts[i];
+        if (symmetric) {
+            p = count[u]++;
+            bySrc[p] = v; byDst[p] = u; byW[p] = wts[i];
+        }
+    }
+
+    // Pass 2: stable counting sort by source, neighbor lists end up sorted
+    offsets = new long long[n + 1];
+    for (int v = 0; v <= n; v++) offsets[v] = 0;
+    for (long long i = 0; i < arcs; i++) offsets[bySrc[i] + 1]++;
+    for (int v = 0; v < n; v++) offsets[v + 1] += offsets[v];
+    for (int v = 0; v <= n; v++) count[v] = offsets[v];
+    neighbors = new int[arcs > 0 ? arcs : 1];
+    weights = new int[arcs > 0 ? arcs : 1];
+    for (long long i = 0; i < arcs; i++) {
+        long long p = count[bySrc[i]]++;
+        neighbors[p] = byDst[i];
+        weights[p] = byW[i];
+    }
+    delete[] bySrc;
+    delete[] byDst;
+    delete[] byW;
+    delete[] count;
+
+    // Merge parallel edges (adjacent after sorting), keeping the smallest weight
+    long long out = 0;
+    long long begin = 0;
+    for (int v = 0; v < n; v++) {
+        long long end = offsets[v + 1];
+        offsets[v] = out;
+        for (long long i = begin; i < end; i++) {
+            if (out > offsets[v] && neighbors[out - 1] == neighbors[i]) {
+                if (weights[i] < weights[out - 1]) weights[out - 1] = weights[i];
+            } else {
+                neighbors[out] = neighbors[i];
+                weights[out] = weights[i];
+                out++;
+            }
+        }
+        begin = end;
+    }
+    offsets[n] = out;
+    arcCount = out;
+}
+
+CSRGraph GraphBuilder::buildCSR(bool symmetric, bool weighted) const {
+    long long* offsets;
+    int* neighbors;
+    int* weights;
+    long long arcs;
+    toCSRArrays(symmetric, offsets, neighbors, weights, arcs);
+    if (!weighted) {
+        delete[] weights;
+        weights = nullptr;
+    }
+    return CSRGraph(numVertices, arcs, offsets, neighbors, weights, symmetric);
+}
+
+template <class WeightPolicy>
+BasicGraph<WeightPolicy> GraphBuilder::buildGraph() const {
+    long long* offsets;
+    int* neighbors;
+    int* weights;
+    long long arcs;
+    toCSRArrays(true, offsets, neighbors, weights, arcs);
+    BasicGraph<WeightPolicy> g(numVertices, offsets, neighbors, weights);
+    delete[] offsets;
+    delete[] neighbors;
+    delete[] weights;
+    return g;
+}
+
+// Explicit instantiations for the supported storage policies
+template BasicGraph<Weighted> GraphBuilder::buildGraph<Weighted>() const;
+template BasicGraph<Unweighted> GraphBuilder::buildGraph<Unweighted>() const;
+template BasicGraph<Interleaved> GraphBuilder::buildGraph<Interleaved>() const;
+
+} // namespace graph
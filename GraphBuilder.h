@@ -0,0 +1,57 @@
+// michael9090124@gmail.com
+
+#ifndef GRAPH_BUILDER_H
+#define GRAPH_BUILDER_H
+
+#include "Graph.h"
+#include "CSRGraph.h"
+
+namespace graph {
+
+// Bulk graph construction from an edge list.
+// Edges are appended in any order (duplicates and self-loops allowed) and converted in
+// O(V + E) with two counting sorts into sorted, duplicate-free adjacency arrays. This is
+// much faster than calling Graph::addEdge per edge, which scans the neighbor list.
+class GraphBuilder {
+private:
+    int numVertices;            // max(id) + 1 seen so far, or the value set by the user
+    long long numEdges;
+    long long capacity;
+    int* srcs;
+    int* dsts;
+    int* wts;
+
+    void grow(long long minCapacity);
+    // Sorted, deduplicated arcs as CSR arrays (caller owns the result)
+    void toCSRArrays(bool symmetric, long long*& offsets, int*& neighbors, int*& weights,
+                     long long& arcCount) const;
+
+public:
+    GraphBuilder(int vertices = 0);
+    ~GraphBuilder();
+    GraphBuilder(const GraphBuilder&) = delete;
+    GraphBuilder& operator=(const GraphBuilder&) = delete;
+
+    void setNumVertices(int vertices);  // Can only grow the vertex count
+    void reserve(long long edges);
+    void addEdge(int src, int dest, int weight = 1);
+    // Append count edges at once (weights may be nullptr for weight 1)
+    void appendEdges(const int* src, const int* dest, const int* weight, long long count);
+    void clear();
+
+    int getNumVertices() const;
+    long long getNumEdges() const;  // Edges appended so far (before deduplication)
+
+    // Build a CSR graph. symmetric=true adds the reverse of every edge (undirected graph),
+    // symmetric=false keeps the arcs as given (directed graph). Self-loops are dropped and
+    // parallel edges are merged keeping the smallest weight. Neighbor lists are sorted.
+    CSRGraph buildCSR(bool symmetric = true, bool weighted = true) const;
+
+    // Build an undirected adjacency-list graph with exact-size neighbor lists
+    template <class WeightPolicy>
+    BasicGraph<WeightPolicy> buildGraph() const;
+};
+
+}
+
+#endif
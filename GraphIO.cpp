@@ -0,0 +1,442 @@
+// michael9090124@gmail.com
+
+#include "GraphIO.h"
+#include "ThreadPool.h"
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace graph {
+
+static const long long MIN_CHUNK_BYTES = 1 << 18;  // Smaller inputs are not worth a thread
+static const long long MAX_ID = 0x7fffffffLL;
+
+// Edges parsed by one thread from its part of the input
+struct EdgeChunk {
+    const char* begin;
+    const char* end;
+    int* src;
+    int* dst;
+    int* w;
+    long long count;
+    long long capacity;
+    bool sawWeight;
+    const char* error;      // First error in this chunk, nullptr if none
+};
+
+static void pushEdge(EdgeChunk& c, int u, int v, int w) {
+    if (c.count == c.capacity) { // Double the local buffers
+        long long newCapacity = c.capacity == 0 ? 4096 : c.capacity * 2;
+        int* newSrc = new int[newCapacity];
+        int* newDst = new int[newCapacity];
+        int* newW = new int[newCapacity];
+        if (c.count > 0) {
+            std::memcpy(newSrc, c.src, c.count * sizeof(int));
+            std::memcpy(newDst, c.dst, c.count * sizeof(int));
+            std::memcpy(newW, c.w, c.count * sizeof(int));
+        }
+        delete[] c.src;
+        delete[] c.dst;
+        delete[] c.w;
+        c.src = newSrc;
+        c.dst = newDst;
+        c.w = newW;
+        c.capacity = newCapacity;
+    }
+    c.src[c.count] = u;
+    c.dst[c.count] = v;
+    c.w[c.count] = w;
+    c.count++;
+}
+
+static inline bool isBlank(char ch) {
+    return ch == ' ' || ch == '\t' || ch == '\r';
+}
+
+static inline const char* skipBlanks(const char* p, const char* end) {
+    while (p < end && isBlank(*p)) p++;
+    return p;
+}
+
+// Position right after the end of the current line
+static inline const char* skipLine(const char* p, const char* end) {
+    const void* nl = std::memchr(p, '\n', end - p);
+    return nl ? static_cast<const char*>(nl) + 1 : end;
+}
+
+// Value of 8 ASCII digits (first digit in the lowest byte), SWAR conversion
+static inline unsigned long long parseEightDigits(unsigned long long chunk) {
+    chunk = (chunk & 0x0F0F0F0F0F0F0F0FULL) * 2561 >> 8;
+    chunk = (chunk & 0x00FF00FF00FF00FFULL) * 6553601 >> 16;
+    return (chunk & 0x0000FFFF0000FFFFULL) * 42949672960001ULL >> 32;
+}
+
+// Parse an unsigned decimal number; returns nullptr if there is no digit at p.
+// Reads 8 bytes at a time while at least 8 bytes remain: one mask finds how many of them
+// are digits and a few multiplications convert them, no per-character branches.
+static inline const char* parseUnsigned(const char* p, const char* end, long long& out) {
+    const char* start = p;
+    long long value = 0;
+    while (end - p >= 8) {
+        unsigned long long chunk;
+        std::memcpy(&chunk, p, 8);
+        // Per byte: high nibble must be 3 and adding 6 must not leave 0x30-0x3F
+        unsigned long long nonDigit = ((chunk & 0xF0F0F0F0F0F0F0F0ULL) ^ 0x3030303030303030ULL)
+                                    | (((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) ^ 0x3030303030303030ULL);
+        int digits = nonDigit == 0 ? 8 : __builtin_ctzll(nonDigit) / 8;
+        if (digits == 0) break;
+        if (digits < 8) { // Left-pad with '0' so the digits fill all 8 bytes
+            int shift = (8 - digits) * 8;
+            chunk = (chunk << shift) | (0x3030303030303030ULL >> (digits * 8));
+            long long scale = 1;
+            for (int i = 0; i < digits; i++) scale *= 10;
+            value = value * scale + (long long)parseEightDigits(chunk);
+            p += digits;
+            break;
+        }
+        value = value * 100000000LL + (long long)parseEightDigits(chunk);
+        p += 8;
+        if (value > MAX_ID * 10) break; // Far out of range, stop early
+    }
+    while (p < end && *p >= '0' && *p <= '9' && value <= MAX_ID * 10) { // Tail
+        value = value * 10 + (*p - '0');
+        p++;
+    }
+    if (p == start) return nullptr;
+    out = value;
+    return p;
+}
+
+static inline const char* parseSigned(const char* p, const char* end, long long& out) {
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        p++;
+    }
+    p = parseUnsigned(p, end, out);
+    if (p != nullptr && negative) out = -out;
+    return p;
+}
+
+// Decimal number with optional fraction and exponent (Matrix Market real values)
+static const char* parseReal(const char* p, const char* end, double& out) {
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        p++;
+    }
+    const char* start = p;
+    double value = 0;
+    while (p < end && *p >= '0' && *p <= '9') value = value * 10 + (*p++ - '0');
+    if (p < end && *p == '.') {
+        p++;
+        double scale = 0.1;
+        while (p < end && *p >= '0' && *p <= '9') {
+            value += (*p++ - '0') * scale;
+            scale *= 0.1;
+        }
+    }
+    if (p == start) return nullptr;
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        long long exponent;
+        const char* q = parseSigned(p + 1, end, exponent);
+        if (q == nullptr) return nullptr;
+        p = q;
+        for (; exponent > 0; exponent--) value *= 10;
+        for (; exponent < 0; exponent++) value /= 10;
+    }
+    out = negative ? -value : value;
+    return p;
+}
+
+// Parse the lines of one chunk; stops at the first malformed line
+static void parseChunk(EdgeChunk* chunk, EdgeListFormat format, bool hasValue, bool realValue) {
+    EdgeChunk& c = *chunk;
+    const char* p = c.begin;
+    const char* end = c.end;
+    int base = format == EdgeListFormat::SNAP ? 0 : 1; // DIMACS and Matrix Market are 1-based
+    while (p < end) {
+        p = skipBlanks(p, end);
+        if (p == end) break;
+        char ch = *p;
+        if (ch == '\n') {
+            p++;
+            continue;
+        }
+        // Comments and header lines
+        if ((format == EdgeListFormat::SNAP && (ch == '#' || ch == '%'))
+            || (format == EdgeListFormat::DIMACS && (ch == 'c' || ch == 'p'))
+            || (format == EdgeListFormat::MatrixMarket && ch == '%')) {
+            p = skipLine(p, end);
+            continue;
+        }
+        if (format == EdgeListFormat::DIMACS) {
+            if (ch != 'a') {
+                c.error = "Malformed DIMACS line!";
+                return;
+            }
+            p = skipBlanks(p + 1, end);
+        }
+
+        long long u, v, w = 1;
+        p = parseUnsigned(p, end, u);
+        if (p != nullptr) p = parseUnsigned(skipBlanks(p, end), end, v);
+        if (p == nullptr) {
+            c.error = "Malformed edge line!";
+            return;
+        }
+        p = skipBlanks(p, end);
+        bool lineEnd = p == end || *p == '\n';
+        if (format == EdgeListFormat::DIMACS || (format == EdgeListFormat::MatrixMarket && hasValue)
+            || (format == EdgeListFormat::SNAP && !lineEnd)) {
+            if (realValue) {
+                double value;
+                p = parseReal(p, end, value);
+                if (p != nullptr && (value > MAX_ID || value < -MAX_ID)) {
+                    value = MAX_ID + 1.0; // Rejected by the range check below
+                }
+                w = (long long)(value < 0 ? value - 0.5 : value + 0.5); // Round to the nearest int
+            } else {
+                p = parseSigned(p, end, w);
+            }
+            if (p == nullptr) {
+                c.error = "Malformed edge weight!";
+                return;
+            }
+            c.sawWeight = true;
+            p = skipBlanks(p, end);
+        }
+        if (p < end && *p != '\n') {
+            c.error = "Unexpected text after edge!";
+            return;
+        }
+        u -= base;
+        v -= base;
+        if (u < 0 || v < 0 || u > MAX_ID || v > MAX_ID || w > MAX_ID || w < -MAX_ID) {
+            c.error = "Edge value out of range!";
+            return;
+        }
+        pushEdge(c, (int)u, (int)v, (int)w);
+    }
+}
+
+// Case-insensitive comparison of a token with a lowercase word
+static bool tokenIs(const char* p, const char* end, const char* word) {
+    int len = (int)std::strlen(word);
+    if (end - p < len) return false;
+    for (int i = 0; i < len; i++) {
+        char ch = p[i];
+        if (ch >= 'A' && ch <= 'Z') ch = ch - 'A' + 'a';
+        if (ch != word[i]) return false;
+    }
+    return p + len == end || isBlank(p[len]) || p[len] == '\n';
+}
+
+static const char* nextToken(const char* p, const char* end) {
+    while (p < end && !isBlank(*p) && *p != '\n') p++;
+    return skipBlanks(p, end);
+}
+
+EdgeListInfo parseEdgeList(const char* data, long long length, EdgeListFormat format,
+                           GraphBuilder& builder, int numThreads) {
+    const char* p = data;
+    const char* end = data + length;
+    EdgeListInfo info;
+    info.numVertices = 0;
+    info.numEdges = 0;
+    info.weighted = format == EdgeListFormat::DIMACS;
+    info.symmetric = false;
+    bool hasValue = false;
+    bool realValue = false;
+
+    // Header (serial, a few lines at most)
+    if (format == EdgeListFormat::DIMACS) {
+        while (p < end) {
+            const char* line = skipBlanks(p, end);
+            if (line < end && *line == 'p') { // "p sp <n> <m>"
+                long long n, m;
+                const char* q = nextToken(nextToken(line, end), end);
+                q = parseUnsigned(q, end, n);
+                if (q != nullptr) q = parseUnsigned(skipBlanks(q, end), end, m);
+                if (q == nullptr || n > MAX_ID) {
+                    throw "Malformed DIMACS problem line!";
+                }
+                info.numVertices = (int)n;
+            } else if (line < end && *line == 'a') {
+                break; // Body starts here
+            }
+            p = skipLine(line, end);
+        }
+    } else if (format == EdgeListFormat::MatrixMarket) {
+        // "%%MatrixMarket matrix coordinate <field> <symmetry>"
+        const char* lineEnd = skipLine(p, end);
+        if (!tokenIs(p, lineEnd, "%%matrixmarket")) {
+            throw "Missing Matrix Market banner!";
+        }
+        const char* q = nextToken(p, lineEnd);
+        if (!tokenIs(q, lineEnd, "matrix")) throw "Matrix Market object must be 'matrix'!";
+        q = nextToken(q, lineEnd);
+        if (!tokenIs(q, lineEnd, "coordinate")) throw "Only coordinate Matrix Market files are supported!";
+        q = nextToken(q, lineEnd);
+        if (tokenIs(q, lineEnd, "pattern")) {
+            hasValue = false;
+        } else if (tokenIs(q, lineEnd, "integer")) {
+            hasValue = true;
+        } else if (tokenIs(q, lineEnd, "real")) {
+            hasValue = true;
+            realValue = true;
+        } else {
+            throw "Unsupported Matrix Market field!";
+        }
+        q = nextToken(q, lineEnd);
+        info.symmetric = !tokenIs(q, lineEnd, "general");
+        info.weighted = hasValue;
+        p = lineEnd;
+        // Comments, then "<rows> <cols> <entries>"
+        while (p < end) {
+            const char* line = skipBlanks(p, end);
+            p = skipLine(line, end);
+            if (line == end || *line == '%' || *line == '\n') continue;
+            long long rows, cols, entries;
+            const char* r = parseUnsigned(line, end, rows);
+            if (r != nullptr) r = parseUnsigned(skipBlanks(r, end), end, cols);
+            if (r != nullptr) r = parseUnsigned(skipBlanks(r, end), end, entries);
+            if (r == nullptr || rows > MAX_ID || cols > MAX_ID) {
+                throw "Malformed Matrix Market size line!";
+            }
+            info.numVertices = (int)(rows > cols ? rows : cols);
+            break;
+        }
+    }
+
+    // Split the body into chunks that start at line boundaries
+    long long bodyLength = end - p;
+    int threads = numThreads > 0 ? numThreads : getNumThreads();
+    if (threads < 1) threads = 1;
+    if (threads > bodyLength / MIN_CHUNK_BYTES) threads = (int)(bodyLength / MIN_CHUNK_BYTES);
+    if (threads < 1) threads = 1;
+
+    EdgeChunk* chunks = new EdgeChunk[threads];
+    const char* chunkStart = p;
+    for (int t = 0; t < threads; t++) {
+        const char* chunkEnd = t == threads - 1 ? end : p + bodyLength * (t + 1) / threads;
+        if (chunkEnd < chunkStart) chunkEnd = chunkStart;
+        if (chunkEnd < end && chunkEnd > data && chunkEnd[-1] != '\n') chunkEnd = skipLine(chunkEnd, end);
+        chunks[t].begin = chunkStart;
+        chunks[t].end = chunkEnd;
+        chunks[t].src = nullptr;
+        chunks[t].dst = nullptr;
+        chunks[t].w = nullptr;
+        chunks[t].count = 0;
+        chunks[t].capacity = 0;
+        chunks[t].sawWeight = false;
+        chunks[t].error = nullptr;
+        chunkStart = chunkEnd;
+    }
+
+    // Parse: chunk 0 on the calling thread, the others on helper threads
+    std::thread* workers = new std::thread[threads];
+    for (int t = 1; t < threads; t++) {
+        workers[t] = std::thread(parseChunk, &chunks[t], format, hasValue, realValue);
+    }
+    parseChunk(&chunks[0], format, hasValue, realValue);
+    for (int t = 1; t < threads; t++) {
+        workers[t].join();
+    }
+    delete[] workers;
+
+    // Append in file order
+    const char* error = nullptr;
+    long long total = 0;
+    for (int t = 0; t < threads; t++) {
+        if (error == nullptr) error = chunks[t].error;
+        total += chunks[t].count;
+        if (chunks[t].sawWeight) info.weighted = true;
+    }
+    if (error == nullptr) {
+        builder.reserve(builder.getNumEdges() + total);
+        builder.setNumVertices(info.numVertices);
+        for (int t = 0; t < threads; t++) {
+            builder.appendEdges(chunks[t].src, chunks[t].dst, chunks[t].w, chunks[t].count);
+        }
+    }
+    for (int t = 0; t < threads; t++) {
+        delete[] chunks[t].src;
+        delete[] chunks[t].dst;
+        delete[] chunks[t].w;
+    }
+    delete[] chunks;
+    if (error != nullptr) {
+        throw error;
+    }
+
+    info.numEdges = total;
+    if (builder.getNumVertices() > info.numVertices) info.numVertices = builder.getNumVertices();
+    return info;
+}
+
+EdgeListInfo readEdgeList(const char* path, EdgeListFormat format, GraphBuilder& builder,
+                          int numThreads) {
+#ifndef _WIN32
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        throw "Cannot open edge list file!";
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        throw "Cannot read edge list file!";
+    }
+    long long size = (long long)st.st_size;
+    if (size == 0) {
+        close(fd);
+        return parseEdgeList("", 0, format, builder, numThreads);
+    }
+    void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        throw "Cannot map edge list file!";
+    }
+    madvise(map, size, MADV_SEQUENTIAL);
+    try {
+        EdgeListInfo info = parseEdgeList(static_cast<const char*>(map), size, format, builder, numThreads);
+        munmap(map, size);
+        return info;
+    } catch (...) {
+        munmap(map, size);
+        throw;
+    }
+#else
+    FILE* file = std::fopen(path, "rb");
+    if (file == nullptr) {
+        throw "Cannot open edge list file!";
+    }
+    std::fseek(file, 0, SEEK_END);
+    long long size = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+    char* buffer = new char[size > 0 ? size : 1];
+    long long got = (long long)std::fread(buffer, 1, size, file);
+    std::fclose(file);
+    if (got != size) {
+        delete[] buffer;
+        throw "Cannot read edge list file!";
+    }
+    try {
+        EdgeListInfo info = parseEdgeList(buffer, size, format, builder, numThreads);
+        delete[] buffer;
+        return info;
+    } catch (...) {
+        delete[] buffer;
+        throw;
+    }
+#endif
+}
+
+} // namespace graph
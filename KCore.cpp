@@ -0,0 +1,187 @@
+// michael9090124@gmail.com
+
+#include "KCore.h"
+#include "Graph.h"
+#include "CSRGraph.h"
+#include "CompressedGraph.h"
+#include "ThreadPool.h"
+#include <climits>
+
+namespace graph {
+
+template <class GraphT>
+int coreDecomposition(const GraphT& g, int* core, int* order) {
+    int n = g.getNumVertices();
+    if (n == 0) return 0;
+    // core[] holds the remaining degrees and ends up holding the core numbers
+    int maxDegree = 0;
+    for (int v = 0; v < n; v++) {
+        int degree = 0;
+        for (Edge e : g.edges(v)) {
+            if (e.dst != v) degree++;
+        }
+        core[v] = degree;
+        if (degree > maxDegree) maxDegree = degree;
+    }
+
+    // Bin sort: vert[bin[d] ..] are the vertices of degree d, pos[v] is v's index in vert
+    int* bin = new int[maxDegree + 1]();
+    int* pos = new int[n];
+    int* vert = order ? order : new int[n];
+    for (int v = 0; v < n; v++) {
+        bin[core[v]]++;
+    }
+    int start = 0;
+    for (int d = 0; d <= maxDegree; d++) {
+        int count = bin[d];
+        bin[d] = start;
+        start += count;
+    }
+    for (int v = 0; v < n; v++) {
+        pos[v] = bin[core[v]]++;
+        vert[pos[v]] = v;
+    }
+    for (int d = maxDegree; d > 0; d--) {
+        bin[d] = bin[d - 1];            // Restore the bin starts
+    }
+    bin[0] = 0;
+
+    // Take vertices in order; a neighbor of larger degree moves down one bin
+    for (int i = 0; i < n; i++) {
+        int v = vert[i];
+        for (Edge e : g.edges(v)) {
+            int u = e.dst;
+            if (core[u] > core[v]) {
+                int du = core[u];
+                int pu = pos[u];
+                int pw = bin[du];       // First vertex of u's bin
+                int w = vert[pw];
+                if (u != w) {
+                    pos[u] = pw;
+                    vert[pu] = w;
+                    pos[w] = pu;
+                    vert[pw] = u;
+                }
+                bin[du]++;
+                core[u]--;
+            }
+        }
+    }
+
+    int degeneracy = core[vert[n - 1]];   // Core numbers never decrease along the order
+    delete[] bin;
+    delete[] pos;
+    if (!order) delete[] vert;
+    return degeneracy;
+}
+
+// Per-thread staging of frontier vertices, flushed to the shared queue in batches
+struct FrontierBuffer {
+    static const int CAPACITY = 256;
+    int* queue;
+    std::atomic<int>& tail;
+    int count = 0;
+    int items[CAPACITY];
+
+    FrontierBuffer(int* queue, std::atomic<int>& tail) : queue(queue), tail(tail) {}
+    ~FrontierBuffer() { flush(); }
+
+    void push(int v) {
+        if (count == CAPACITY) flush();
+        items[count++] = v;
+    }
+
+    void flush() {
+        int at = tail.fetch_add(count);
+        for (int i = 0; i < count; i++) {
+            queue[at + i] = items[i];
+        }
+        count = 0;
+    }
+};
+
+template <class GraphT>
+int parallelCoreDecomposition(const GraphT& g, int* core, int* order) {
+    int n = g.getNumVertices();
+    if (n == 0) return 0;
+    std::atomic<int>* degree = new std::atomic<int>[n];
+    int* queue = order ? order : new int[n];
+    parallel_for(0, n, [&](long long begin, long long end) {
+        for (long long v = begin; v < end; v++) {
+            int d = 0;
+            for (Edge e : g.edges((int)v)) {
+                if (e.dst != v) d++;
+            }
+            degree[v].store(d, std::memory_order_relaxed);
+            core[v] = -1;               // Not peeled yet
+        }
+    });
+
+    int peeled = 0;
+    int k = 0;
+    while (peeled < n) {
+        // Skip the levels with no vertex: k = the smallest remaining degree
+        std::atomic<int> minDegree(INT_MAX);
+        parallel_for(0, n, [&](long long begin, long long end) {
+            int local = INT_MAX;
+            for (long long v = begin; v < end; v++) {
+                int d = degree[v].load(std::memory_order_relaxed);
+                if (core[v] == -1 && d < local) local = d;
+            }
+            int seen = minDegree.load();
+            while (local < seen && !minDegree.compare_exchange_weak(seen, local)) {}
+        });
+        if (minDegree.load() > k) k = minDegree.load();
+
+        // First frontier of level k, then peel until no degree drops to k
+        std::atomic<int> tail(peeled);
+        parallel_for(0, n, [&](long long begin, long long end) {
+            FrontierBuffer buffer(queue, tail);
+            for (long long v = begin; v < end; v++) {
+                if (core[v] == -1 && degree[v].load(std::memory_order_relaxed) <= k) {
+                    core[v] = k;
+                    buffer.push((int)v);
+                }
+            }
+        });
+        int first = peeled;
+        int last = tail.load();
+        while (first < last) {
+            parallel_for(first, last, [&](long long begin, long long end) {
+                FrontierBuffer buffer(queue, tail);
+                for (long long i = begin; i < end; i++) {
+                    int v = queue[i];
+                    for (Edge e : g.edges(v)) {
+                        int u = e.dst;
+                        // Only the thread that takes u from k + 1 to k sees that value
+                        if (u != v && degree[u].fetch_sub(1, std::memory_order_relaxed) == k + 1) {
+                            core[u] = k;
+                            buffer.push(u);
+                        }
+                    }
+                }
+            });
+            first = last;
+            last = tail.load();
+        }
+        peeled = last;
+    }
+
+    delete[] degree;
+    if (!order) delete[] queue;
+    return k;
+}
+
+// Explicit instantiations for the supported graph storages
+template int coreDecomposition<Graph>(const Graph&, int*, int*);
+template int coreDecomposition<UnweightedGraph>(const UnweightedGraph&, int*, int*);
+template int coreDecomposition<InterleavedGraph>(const InterleavedGraph&, int*, int*);
+template int coreDecomposition<CSRGraph>(const CSRGraph&, int*, int*);
+template int coreDecomposition<CompressedGraph>(const CompressedGraph&, int*, int*);
+template int parallelCoreDecomposition<Graph>(const Graph&, int*, int*);
+template int parallelCoreDecomposition<UnweightedGraph>(const UnweightedGraph&, int*, int*);
+template int parallelCoreDecomposition<InterleavedGraph>(const InterleavedGraph&, int*, int*);
+template int parallelCoreDecomposition<CSRGraph>(const CSRGraph&, int*, int*);
+template int parallelCoreDecomposition<CompressedGraph>(const CompressedGraph&, int*, int*);
+
+} // namespace graph
@@ -0,0 +1,28 @@
+// michael9090124@gmail.com
+
+#ifndef KCORE_H
+#define KCORE_H
+
+namespace graph {
+
+// k-core decomposition: core[v] is the largest k such that v belongs to a subgraph where
+// every vertex has degree >= k. g must be symmetric (undirected) without parallel edges;
+// self-loops are ignored. order (optional) receives a degeneracy ordering: every vertex has
+// at most degeneracy neighbors after it. Both return the degeneracy (the largest core number).
+
+// Batagelj-Zaversnik: vertices bin-sorted by degree in one array, always taking the next
+// vertex of smallest remaining degree. Decrementing a neighbor swaps it with the first vertex
+// of its bin and moves the bin boundary, so everything is updated in place in O(n + m).
+template <class GraphT>
+int coreDecomposition(const GraphT& g, int* core, int* order = nullptr);
+
+// Level-synchronous peeling on the thread pool. For k = the smallest remaining degree, the
+// vertices of degree <= k form a frontier that is peeled in parallel: every neighbor's degree
+// is decremented atomically, and the thread that brings it from k + 1 to k appends it to the
+// next frontier. Frontiers are stored one after the other in order. O(n * levels + m) work.
+template <class GraphT>
+int parallelCoreDecomposition(const GraphT& g, int* core, int* order = nullptr);
+
+}
+
+#endif
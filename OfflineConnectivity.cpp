@@ -0,0 +1,170 @@
+// michael9090124@gmail.com
+
+#include "OfflineConnectivity.h"
+#include "Graph.h"
+#include "CSRGraph.h"
+#include "CompressedGraph.h"
+#include "DataStructures.h"
+
+namespace graph {
+
+// Segment tree over the queries [0, q): node ids in heap order, edge lists in CSR form
+struct QuerySegmentTree {
+    int q;
+    int* offsets;           // Edges of node x are edges[offsets[x] .. offsets[x + 1])
+    int* fill;              // Next free position of each node while filling
+    int* edges;
+
+    // Counting pass (edge == -1) or filling pass: the nodes covering [a, b)
+    void cover(int x, int lo, int hi, int a, int b, int edge) {
+        if (b <= lo || hi <= a) return;
+        if (a <= lo && hi <= b) {
+            if (edge == -1) offsets[x + 1]++;
+            else edges[fill[x]++] = edge;
+            return;
+        }
+        int mid = (lo + hi) / 2;
+        cover(2 * x, lo, mid, a, b, edge);
+        cover(2 * x + 1, mid, hi, a, b, edge);
+    }
+
+    void solve(int x, int lo, int hi, RollbackUnionFind& uf, const int* edgeU, const int* edgeV,
+               const OfflineOp* queries, int* answers) const {
+        int snapshot = uf.snapshot();
+        for (int i = offsets[x]; i < offsets[x + 1]; i++) {
+            uf.unionSets(edgeU[edges[i]], edgeV[edges[i]]);
+        }
+        if (hi - lo == 1) {
+            const OfflineOp& op = queries[lo];
+            if (op.type == OFFLINE_CONNECTED) {
+                answers[lo] = uf.find(op.u) == uf.find(op.v) ? 1 : 0;
+            } else {
+                answers[lo] = uf.numComponents();
+            }
+        } else {
+            int mid = (lo + hi) / 2;
+            solve(2 * x, lo, mid, uf, edgeU, edgeV, queries, answers);
+            solve(2 * x + 1, mid, hi, uf, edgeU, edgeV, queries, answers);
+        }
+        uf.rollback(snapshot);
+    }
+};
+
+template <class GraphT>
+int offlineConnectivity(const GraphT& g, const OfflineOp* ops, int numOps, int* answers) {
+    int n = g.getNumVertices();
+
+    // Edge intervals [begin, end) in query indices. An edge's id is the index of its interval.
+    int capacity = 16;
+    int* edgeU = new int[capacity];
+    int* edgeV = new int[capacity];
+    int* begin = new int[capacity];
+    int* end = new int[capacity];
+    int numIntervals = 0;
+    EdgeMap open;           // Edge -> interval still open
+    OfflineOp* queries = new OfflineOp[numOps > 0 ? numOps : 1];
+    int q = 0;
+
+    auto openInterval = [&](int u, int v) {
+        if (numIntervals == capacity) {
+            capacity *= 2;
+            int* arrays[4] = {edgeU, edgeV, begin, end};
+            for (int a = 0; a < 4; a++) {
+                int* larger = new int[capacity];
+                for (int i = 0; i < numIntervals; i++) {
+                    larger[i] = arrays[a][i];
+                }
+                delete[] arrays[a];
+                arrays[a] = larger;
+            }
+            edgeU = arrays[0];
+            edgeV = arrays[1];
+            begin = arrays[2];
+            end = arrays[3];
+        }
+        edgeU[numIntervals] = u;
+        edgeV[numIntervals] = v;
+        begin[numIntervals] = q;
+        end[numIntervals] = -1;
+        open.insert(u, v, numIntervals++);
+    };
+
+    try {
+        for (int u = 0; u < n; u++) {
+            for (Edge e : g.edges(u)) {
+                if (u < e.dst && open.find(u, e.dst) == -1) openInterval(u, e.dst);
+            }
+        }
+        for (int i = 0; i < numOps; i++) {
+            const OfflineOp& op = ops[i];
+            if (op.type != OFFLINE_COMPONENTS && (op.u < 0 || op.u >= n || op.v < 0 || op.v >= n)) {
+                throw "Invalid vertex!";
+            }
+            if (op.type == OFFLINE_ADD) {
+                if (op.u == op.v) {
+                    throw "Self-loops are not allowed!";
+                }
+                if (open.find(op.u, op.v) == -1) openInterval(op.u, op.v);
+            } else if (op.type == OFFLINE_REMOVE) {
+                int id = open.find(op.u, op.v);
+                if (id == -1) {
+                    throw "Edge does not exist!";
+                }
+                end[id] = q;
+                open.erase(op.u, op.v);
+            } else {
+                queries[q++] = op;
+            }
+        }
+    } catch (...) {
+        delete[] edgeU;
+        delete[] edgeV;
+        delete[] begin;
+        delete[] end;
+        delete[] queries;
+        throw;
+    }
+
+    if (q > 0) {
+        QuerySegmentTree tree;
+        tree.q = q;
+        int nodes = 4 * q;
+        tree.offsets = new int[nodes + 1]();
+        for (int i = 0; i < numIntervals; i++) {
+            if (end[i] == -1) end[i] = q;   // Still present after the last operation
+            tree.cover(1, 0, q, begin[i], end[i], -1);
+        }
+        for (int x = 0; x < nodes; x++) {
+            tree.offsets[x + 1] += tree.offsets[x];
+        }
+        tree.fill = new int[nodes];
+        for (int x = 0; x < nodes; x++) {
+            tree.fill[x] = tree.offsets[x];
+        }
+        tree.edges = new int[tree.offsets[nodes] > 0 ? tree.offsets[nodes] : 1];
+        for (int i = 0; i < numIntervals; i++) {
+            tree.cover(1, 0, q, begin[i], end[i], i);
+        }
+        RollbackUnionFind uf(n);
+        tree.solve(1, 0, q, uf, edgeU, edgeV, queries, answers);
+        delete[] tree.offsets;
+        delete[] tree.fill;
+        delete[] tree.edges;
+    }
+
+    delete[] edgeU;
+    delete[] edgeV;
+    delete[] begin;
+    delete[] end;
+    delete[] queries;
+    return q;
+}
+
+// Explicit instantiations for the supported graph storages
+template int offlineConnectivity<Graph>(const Graph&, const OfflineOp*, int, int*);
+template int offlineConnectivity<UnweightedGraph>(const UnweightedGraph&, const OfflineOp*, int, int*);
+template int offlineConnectivity<InterleavedGraph>(const InterleavedGraph&, const OfflineOp*, int, int*);
+template int offlineConnectivity<CSRGraph>(const CSRGraph&, const OfflineOp*, int, int*);
+template int offlineConnectivity<CompressedGraph>(const CompressedGraph&, const OfflineOp*, int, int*);
+
+} // namespace graph
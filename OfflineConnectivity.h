@@ -0,0 +1,33 @@
+// michael9090124@gmail.com
+
+#ifndef OFFLINE_CONNECTIVITY_H
+#define OFFLINE_CONNECTIVITY_H
+
+namespace graph {
+
+enum OfflineOpType {
+    OFFLINE_ADD,            // Add edge {u, v} (ignored if it is present, like Graph::addEdge)
+    OFFLINE_REMOVE,         // Remove edge {u, v} (throws if it is absent)
+    OFFLINE_CONNECTED,      // Query: answer 1 if u and v are connected, else 0
+    OFFLINE_COMPONENTS      // Query: answer the number of connected components (u, v unused)
+};
+
+struct OfflineOp {
+    OfflineOpType type;
+    int u;
+    int v;
+};
+
+// Answers all the queries of a known sequence of edge additions and removals, starting
+// from the edges of g (nothing in g changes). answers receives one int per query, in order.
+// Every edge lives during an interval of queries. The intervals are spread over a segment
+// tree on the query indices, then a depth-first walk unions the edges of each node on the
+// way down and rolls them back on the way up (RollbackUnionFind), so every leaf sees
+// exactly the edges alive at its query. O((m + q) log q log n) for m edge intervals and q queries.
+// Returns the number of queries.
+template <class GraphT>
+int offlineConnectivity(const GraphT& g, const OfflineOp* ops, int numOps, int* answers);
+
+}
+
+#endif
@@ -0,0 +1,185 @@
+// michael9090124@gmail.com
+
+#include "PageRank.h"
+#include "ThreadPool.h"
+#include <cmath>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace graph {
+
+PageRank::PageRank(const CSRGraph& g) : n(g.getNumVertices()) {
+    const long long* offsets = g.getOffsets();
+    const int* neighbors = g.getNeighbors();
+    long long m = g.getNumEdges();
+    int size = n > 0 ? n : 1;
+    inOffsets = new long long[size + 1]();
+    inSources = new int[m > 0 ? m : 1];
+    invOutDegree = new float[size];
+    dangling = new int[size];
+    numDangling = 0;
+
+    // Transpose with a counting sort (a symmetric graph is its own transpose)
+    for (long long i = 0; i < (n > 0 ? offsets[n] : 0); i++) {
+        inOffsets[neighbors[i] + 1]++;
+    }
+    for (int v = 0; v < n; v++) {
+        inOffsets[v + 1] += inOffsets[v];
+    }
+    long long* fill = new long long[size];
+    for (int v = 0; v < n; v++) {
+        fill[v] = inOffsets[v];
+    }
+    for (int u = 0; u < n; u++) {
+        long long degree = offsets[u + 1] - offsets[u];
+        invOutDegree[u] = degree > 0 ? 1.0f / degree : 0.0f;
+        if (degree == 0) dangling[numDangling++] = u;
+        for (long long i = offsets[u]; i < offsets[u + 1]; i++) {
+            inSources[fill[neighbors[i]]++] = u;
+        }
+    }
+    delete[] fill;
+
+    current = new float[size];
+    next = new float[size];
+    contribution = new float[size];
+}
+
+PageRank::~PageRank() {
+    delete[] inOffsets;
+    delete[] inSources;
+    delete[] invOutDegree;
+    delete[] dangling;
+    delete[] current;
+    delete[] next;
+    delete[] contribution;
+}
+
+// Sum of contribution[sources[i]] for i in [0, count)
+static inline float gatherSum(const float* contribution, const int* sources, long long count) {
+    long long i = 0;
+    float sum = 0.0f;
+#ifdef __AVX2__
+    __m256 acc = _mm256_setzero_ps();
+    for (; i + 8 <= count; i += 8) {
+        __m256i index = _mm256_loadu_si256((const __m256i*)(sources + i));
+        acc = _mm256_add_ps(acc, _mm256_i32gather_ps(contribution, index, 4));
+    }
+    __m128 half = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+    half = _mm_add_ss(half, _mm_shuffle_ps(half, half, 1));
+    sum = _mm_cvtss_f32(half);
+#endif
+    // Four independent accumulators, so the adds don't wait on each other
+    float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+    for (; i + 4 <= count; i += 4) {
+        s0 += contribution[sources[i]];
+        s1 += contribution[sources[i + 1]];
+        s2 += contribution[sources[i + 2]];
+        s3 += contribution[sources[i + 3]];
+    }
+    for (; i < count; i++) {
+        s0 += contribution[sources[i]];
+    }
+    return sum + (s0 + s1) + (s2 + s3);
+}
+
+// Sum of term(v) over [0, n) on the thread pool
+template <class Term>
+static double parallelSum(int n, const Term& term) {
+    std::atomic<double> total(0.0);
+    parallel_for(0, n, [&](long long begin, long long end) {
+        double local = 0.0;
+        for (long long v = begin; v < end; v++) {
+            local += term((int)v);
+        }
+        double seen = total.load();
+        while (!total.compare_exchange_weak(seen, seen + local)) {}
+    });
+    return total.load();
+}
+
+int PageRank::iterate(const int* seeds, const float* restart, int numSeeds, float* rank,
+                      float damping, float tolerance, int maxIterations) {
+    if (n == 0) return 0;
+    if (damping < 0.0f || damping >= 1.0f) {
+        throw "Damping factor must be in [0, 1)!";
+    }
+    float uniform = 1.0f / n;
+    for (int v = 0; v < n; v++) {
+        current[v] = restart ? 0.0f : uniform;
+    }
+    for (int i = 0; i < numSeeds; i++) {
+        current[seeds[i]] += restart[i];
+    }
+
+    int iterations = 0;
+    while (iterations < maxIterations) {
+        iterations++;
+        parallel_for(0, n, [&](long long begin, long long end) {
+            for (long long u = begin; u < end; u++) {
+                contribution[u] = current[u] * invOutDegree[u];
+            }
+        });
+        double danglingMass = 0.0;
+        for (int i = 0; i < numDangling; i++) {
+            danglingMass += current[dangling[i]];
+        }
+        // Teleports plus dangling rank, spread like the restart vector
+        float restartMass = (float)((1.0 - damping) + damping * danglingMass);
+        float base = restart ? 0.0f : restartMass * uniform;
+        parallel_for_weighted(0, n, inOffsets, [&](long long begin, long long end) {
+            for (long long v = begin; v < end; v++) {
+                long long first = inOffsets[v];
+                next[v] = base + damping * gatherSum(contribution, inSources + first, inOffsets[v + 1] - first);
+            }
+        });
+        for (int i = 0; i < numSeeds; i++) {
+            next[seeds[i]] += restartMass * restart[i];
+        }
+        double change = parallelSum(n, [&](int v) { return std::fabs((double)next[v] - current[v]); });
+        float* tmp = current;
+        current = next;
+        next = tmp;
+        if (change < tolerance) break;
+    }
+    for (int v = 0; v < n; v++) {
+        rank[v] = current[v];
+    }
+    return iterations;
+}
+
+int PageRank::run(float* rank, float damping, float tolerance, int maxIterations) {
+    return iterate(nullptr, nullptr, 0, rank, damping, tolerance, maxIterations);
+}
+
+int PageRank::runPersonalized(const int* seeds, const float* weights, int numSeeds, float* rank,
+                              float damping, float tolerance, int maxIterations) {
+    double total = 0.0;
+    for (int i = 0; i < numSeeds; i++) {
+        if (seeds[i] < 0 || seeds[i] >= n) {
+            throw "Invalid vertex!";
+        }
+        total += weights ? weights[i] : 1.0f;
+    }
+    if (!(total > 0.0)) {
+        throw "Invalid restart vector!";
+    }
+    float* restart = new float[numSeeds];
+    for (int i = 0; i < numSeeds; i++) {
+        restart[i] = (float)((weights ? weights[i] : 1.0f) / total);
+    }
+    int iterations;
+    try {
+        iterations = iterate(seeds, restart, numSeeds, rank, damping, tolerance, maxIterations);
+    } catch (...) {
+        delete[] restart;
+        throw;
+    }
+    delete[] restart;
+    return iterations;
+}
+
+} // namespace graph
@@ -0,0 +1,189 @@
+// michael9090124@gmail.com
+
+#include "PerfCounters.h"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace graph {
+
+#ifdef __linux__
+static int openEvent(unsigned int type, unsigned long long config) {
+    struct perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // pid 0, cpu -1: the calling thread on any CPU
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static unsigned long long cacheEvent(unsigned int cache) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+#endif
+
+PerfCounters::PerfCounters() {
+    for (int i = 0; i < NUM_EVENTS; i++) {
+        fds[i] = -1;
+    }
+#ifdef __linux__
+    fds[0] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    fds[1] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    fds[2] = openEvent(PERF_TYPE_HW_CACHE, cacheEvent(PERF_COUNT_HW_CACHE_LL));
+    if (fds[2] < 0) fds[2] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    fds[3] = openEvent(PERF_TYPE_HW_CACHE, cacheEvent(PERF_COUNT_HW_CACHE_DTLB));
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+    for (int i = 0; i < NUM_EVENTS; i++) {
+        if (fds[i] >= 0) close(fds[i]);
+    }
+#endif
+}
+
+bool PerfCounters::available() const {
+    for (int i = 0; i < NUM_EVENTS; i++) {
+        if (fds[i] >= 0) return true;
+    }
+    return false;
+}
+
+void PerfCounters::start() {
+#ifdef __linux__
+    for (int i = 0; i < NUM_EVENTS; i++) {
+        if (fds[i] < 0) continue;
+        ioctl(fds[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+PerfCounts PerfCounters::stop() {
+    long long values[NUM_EVENTS];
+    for (int i = 0; i < NUM_EVENTS; i++) {
+        values[i] = -1;
+    }
+#ifdef __linux__
+    for (int i = 0; i < NUM_EVENTS; i++) {
+        if (fds[i] >= 0) ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+    }
+    for (int i = 0; i < NUM_EVENTS; i++) {
+        unsigned long long data[3]; // value, time enabled, time running
+        if (fds[i] < 0 || read(fds[i], data, sizeof(data)) != (ssize_t)sizeof(data)) continue;
+        if (data[2] == 0) {
+            values[i] = 0;      // Never scheduled on the PMU
+        } else if (data[2] < data[1]) {
+            values[i] = (long long)((double)data[0] * data[1] / data[2]); // Multiplexed, scale up
+        } else {
+            values[i] = (long long)data[0];
+        }
+    }
+#endif
+    PerfCounts counts;
+    counts.cycles = values[0];
+    counts.instructions = values[1];
+    counts.llcMisses = values[2];
+    counts.dtlbMisses = values[3];
+    return counts;
+}
+
+// Runtime switch, initialized from the environment
+static std::atomic<bool> logSamples(std::getenv("GRAPH_PERF_COUNTERS") != nullptr);
+static std::atomic<bool> enabledFlag(logSamples.load());
+
+// Per-thread state: counters are opened on first use and reused
+static thread_local PerfCounters* threadCounters = nullptr;
+static thread_local int scopeDepth = 0;
+static thread_local PerfSample threadLast = {nullptr, 0, 0, {-1, -1, -1, -1}};
+
+// Closes the calling thread's counters when the thread exits
+struct ThreadCountersOwner {
+    ~ThreadCountersOwner() {
+        delete threadCounters;
+        threadCounters = nullptr;
+    }
+};
+static thread_local ThreadCountersOwner threadCountersOwner;
+
+void setPerfCounters(bool enabled) {
+    enabledFlag.store(enabled);
+}
+
+bool perfCountersEnabled() {
+    return enabledFlag.load(std::memory_order_relaxed);
+}
+
+PerfSample lastPerfSample() {
+    return threadLast;
+}
+
+void printPerfSample(const PerfSample& sample, FILE* out) {
+    if (sample.name == nullptr) {
+        return;
+    }
+    const char* labels[4] = {"cycles", "instructions", "llc-misses", "dtlb-misses"};
+    long long values[4] = {sample.counts.cycles, sample.counts.instructions,
+                           sample.counts.llcMisses, sample.counts.dtlbMisses};
+    std::fprintf(out, "[perf] %s: %d vertices, %lld edges\n", sample.name, sample.vertices, sample.edges);
+    for (int i = 0; i < 4; i++) {
+        if (values[i] < 0) {
+            std::fprintf(out, "[perf]   %-12s unavailable\n", labels[i]);
+            continue;
+        }
+        double perVertex = sample.vertices > 0 ? (double)values[i] / sample.vertices : 0;
+        double perEdge = sample.edges > 0 ? (double)values[i] / sample.edges : 0;
+        std::fprintf(out, "[perf]   %-12s %14lld  %10.3f / vertex  %10.3f / edge\n",
+                     labels[i], values[i], perVertex, perEdge);
+    }
+}
+
+PerfScope::PerfScope(const char* name, int vertices, long long edges) : active(false), nested(false) {
+    if (!perfCountersEnabled()) {
+        return;
+    }
+    if (scopeDepth++ > 0) {
+        nested = true;
+        return;
+    }
+    if (threadCounters == nullptr) {
+        (void)&threadCountersOwner; // Make sure the owner exists for this thread
+        threadCounters = new PerfCounters();
+    }
+    active = true;
+    sample.name = name;
+    sample.vertices = vertices;
+    sample.edges = edges;
+    threadCounters->start();
+}
+
+PerfScope::~PerfScope() {
+    if (nested) {
+        scopeDepth--;
+        return;
+    }
+    if (!active) {
+        return;
+    }
+    sample.counts = threadCounters->stop();
+    scopeDepth--;
+    threadLast = sample;
+    if (logSamples.load(std::memory_order_relaxed)) {
+        printPerfSample(sample, stderr);
+    }
+}
+
+} // namespace graph
@@ -0,0 +1,72 @@
+// michael9090124@gmail.com
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <cstdio>
+
+namespace graph {
+
+// Hardware counter values of one measured region (user space only).
+// A counter the machine / kernel does not provide (no PMU in a VM, perf_event_paranoid,
+// non-Linux build) is -1.
+struct PerfCounts {
+    long long cycles;
+    long long instructions;
+    long long llcMisses;        // Last level cache read misses
+    long long dtlbMisses;       // Data TLB read misses
+};
+
+// Linux perf_event_open counters for the calling thread.
+// Each event is opened on its own, so a missing one does not disable the others; values
+// are scaled if the kernel multiplexed the counters.
+class PerfCounters {
+private:
+    static const int NUM_EVENTS = 4;
+    int fds[NUM_EVENTS];        // -1 for unavailable events
+
+public:
+    PerfCounters();
+    ~PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available() const;     // At least one counter could be opened
+    void start();               // Reset and enable
+    PerfCounts stop();          // Disable and read
+};
+
+// One instrumented Algorithms call
+struct PerfSample {
+    const char* name;           // Entry point ("bfs", "dijkstra", ...), nullptr if none yet
+    int vertices;
+    long long edges;            // Adjacency entries (each undirected edge counts twice)
+    PerfCounts counts;
+};
+
+// Runtime switch for the Algorithms instrumentation (off by default, no cost when off).
+// Setting the environment variable GRAPH_PERF_COUNTERS turns it on at startup and prints
+// every sample to stderr.
+void setPerfCounters(bool enabled);
+bool perfCountersEnabled();
+PerfSample lastPerfSample();    // Most recent sample of the calling thread
+void printPerfSample(const PerfSample& sample, FILE* out); // Counts per vertex and per edge
+
+// Measures the enclosing scope when instrumentation is enabled. Nested scopes on the same
+// thread are not measured again (only the outermost one is recorded).
+class PerfScope {
+private:
+    bool active;                // Outermost enabled scope: measures
+    bool nested;                // Inside another scope: only tracks the depth
+    PerfSample sample;
+
+public:
+    PerfScope(const char* name, int vertices, long long edges);
+    ~PerfScope();
+    PerfScope(const PerfScope&) = delete;
+    PerfScope& operator=(const PerfScope&) = delete;
+};
+
+}
+
+#endif
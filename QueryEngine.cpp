@@ -0,0 +1,255 @@
+// michael9090124@gmail.com
+
+#include "QueryEngine.h"
+#include "DataStructures.h"
+#include <thread>
+#include <utility>
+
+namespace graph {
+
+QueryEngine::Workspace::Workspace()
+    : busy(false), temporary(false), heap(nullptr), queue(nullptr), dist(nullptr), stamp(nullptr), epoch(0) {}
+
+QueryEngine::Workspace::~Workspace() {
+    delete heap;
+    delete[] queue;
+    delete[] dist;
+    delete[] stamp;
+}
+
+void QueryEngine::Workspace::init(int n) {
+    int size = n > 0 ? n : 1;
+    heap = new IndexedHeap(size);
+    queue = new int[size];
+    dist = new int[size];
+    stamp = new unsigned int[size]();
+    epoch = 0;
+}
+
+// Starting slot of the calling thread, spreads threads over the pool
+static std::atomic<unsigned int> nextHint(0);
+static thread_local unsigned int threadHint = nextHint.fetch_add(1, std::memory_order_relaxed);
+
+QueryEngine::QueryEngine(CSRGraph&& g, int count)
+    : graph(std::move(g)), negativeWeights(false), potential(nullptr), reducedWeights(nullptr) {
+    if (count <= 0) {
+        count = (int)std::thread::hardware_concurrency();
+        if (count <= 0) count = 1;
+    }
+    const int* weights = graph.getWeights();
+    if (weights != nullptr) {
+        for (long long i = 0; i < graph.getNumEdges(); i++) {
+            if (weights[i] < 0) {
+                negativeWeights = true;
+                break;
+            }
+        }
+    }
+    if (negativeWeights) {
+        reweight();
+    }
+    numWorkspaces = count;
+    workspaces = new Workspace[count];
+    for (int i = 0; i < count; i++) {
+        workspaces[i].init(graph.getNumVertices());
+    }
+}
+
+QueryEngine::~QueryEngine() {
+    delete[] workspaces;
+    delete[] potential;
+    delete[] reducedWeights;
+}
+
+// Johnson reweighting: the reduced weights are non-negative and every path from s to t
+// changes by the same amount h[s] - h[t], so shortest paths are preserved
+void QueryEngine::reweight() {
+    int n = graph.getNumVertices();
+    long long m = graph.getNumEdges();
+    int* h = new int[n > 0 ? n : 1];
+    try {
+        BasicAlgorithms<CSRGraph>(graph).johnsonPotentials(h);
+    } catch (const char*) {
+        delete[] h;
+        throw;
+    }
+    const long long* offsets = graph.getOffsets();
+    const int* neighbors = graph.getNeighbors();
+    const int* weights = graph.getWeights();
+    int* reduced = new int[m > 0 ? m : 1];
+    for (int u = 0; u < n; u++) {
+        for (long long i = offsets[u]; i < offsets[u + 1]; i++) {
+            long long w = (long long)weights[i] + h[u] - h[neighbors[i]];
+            if (w > 0x7fffffff) {
+                delete[] h;
+                delete[] reduced;
+                throw "Distances too large for reweighting!";
+            }
+            reduced[i] = (int)w;
+        }
+    }
+    potential = h;
+    reducedWeights = reduced;
+}
+
+// Distance with the original weights from the one found with the reduced weights: the path
+// changed by h[source] - h[target]. Computed in 64 bits, the result may not fit in an int.
+int QueryEngine::originalDistance(int source, int target, int reduced) const {
+    long long d = (long long)reduced - potential[source] + potential[target];
+    if (d >= DIST_INF || d < -0x7fffffffLL) {
+        throw "Distance too large!";
+    }
+    return (int)d;
+}
+
+QueryEngine::Workspace* QueryEngine::acquire() const {
+    unsigned int start = threadHint;
+    for (int k = 0; k < numWorkspaces; k++) {
+        Workspace* ws = &workspaces[(start + k) % numWorkspaces];
+        // Test first so busy slots are not written to
+        if (!ws->busy.load(std::memory_order_relaxed) &&
+            !ws->busy.exchange(true, std::memory_order_acquire)) {
+            return ws;
+        }
+    }
+    Workspace* ws = new Workspace(); // Pool exhausted: temporary workspace
+    ws->temporary = true;
+    ws->init(graph.getNumVertices());
+    return ws;
+}
+
+void QueryEngine::release(Workspace* ws) const {
+    if (ws->temporary) {
+        delete ws;
+    } else {
+        ws->busy.store(false, std::memory_order_release);
+    }
+}
+
+int QueryEngine::bfs(int source, int* dist) const {
+    int n = graph.getNumVertices();
+    if (source < 0 || source >= n) {
+        throw "Invalid starting vertex!";
+    }
+    Workspace* ws = acquire();
+    Lease lease = {this, ws};
+
+    const long long* offsets = graph.getOffsets();
+    const int* neighbors = graph.getNeighbors();
+    for (int v = 0; v < n; v++) {
+        dist[v] = -1;
+    }
+    int* queue = ws->queue;         // Every vertex is enqueued at most once
+    int head = 0, tail = 0;
+    dist[source] = 0;
+    queue[tail++] = source;
+    while (head < tail) {
+        int u = queue[head++];
+        for (long long i = offsets[u]; i < offsets[u + 1]; i++) {
+            int v = neighbors[i];
+            if (dist[v] == -1) {
+                dist[v] = dist[u] + 1;
+                queue[tail++] = v;
+            }
+        }
+    }
+    return tail;
+}
+
+int QueryEngine::dijkstra(int source, int* dist, int* parent) const {
+    int n = graph.getNumVertices();
+    if (source < 0 || source >= n) {
+        throw "Invalid starting vertex!";
+    }
+    Workspace* ws = acquire();
+    Lease lease = {this, ws};
+
+    const int INF = DIST_INF;
+    const long long* offsets = graph.getOffsets();
+    const int* neighbors = graph.getNeighbors();
+    const int* weights = searchWeights();
+    // With negative weights the search runs in the workspace and the results are copied out
+    // once every distance is translated, so a distance that doesn't fit (originalDistance
+    // throws) leaves dist and parent untouched
+    int* d = potential ? ws->dist : dist;
+    int* tree = potential && parent != nullptr ? ws->queue : parent;
+    for (int v = 0; v < n; v++) {
+        d[v] = INF;
+        if (tree != nullptr) tree[v] = -1;
+    }
+    IndexedHeap& heap = *ws->heap;
+    d[source] = 0;
+    heap.pushOrDecrease(source, 0);
+    int reached = 0;
+    while (!heap.isEmpty()) {
+        int u = heap.popMin().vertex; // Settled: no stale entries with an indexed heap
+        reached++;
+        for (long long i = offsets[u]; i < offsets[u + 1]; i++) {
+            int v = neighbors[i];
+            long long candidate = (long long)d[u] + (weights ? weights[i] : 1);
+            if (candidate < d[v]) {
+                d[v] = (int)candidate;
+                if (tree != nullptr) tree[v] = u;
+                heap.pushOrDecrease(v, d[v]);
+            }
+        }
+    }
+    if (potential != nullptr) {     // Back to the original weights
+        for (int v = 0; v < n; v++) {
+            if (d[v] != INF) d[v] = originalDistance(source, v, d[v]);
+        }
+        for (int v = 0; v < n; v++) {
+            dist[v] = d[v];
+            if (parent != nullptr) parent[v] = tree[v];
+        }
+    }
+    return reached;
+}
+
+int QueryEngine::distance(int source, int target) const {
+    int n = graph.getNumVertices();
+    if (source < 0 || source >= n || target < 0 || target >= n) {
+        throw "Invalid vertex!";
+    }
+    Workspace* ws = acquire();
+    Lease lease = {this, ws};
+
+    // New epoch: every scratch distance from older queries becomes invalid at once
+    if (++ws->epoch == 0) {
+        for (int v = 0; v < n; v++) ws->stamp[v] = 0;
+        ws->epoch = 1;
+    }
+    unsigned int epoch = ws->epoch;
+    int* dist = ws->dist;
+    unsigned int* stamp = ws->stamp;
+    const long long* offsets = graph.getOffsets();
+    const int* neighbors = graph.getNeighbors();
+    const int* weights = searchWeights();
+    IndexedHeap& heap = *ws->heap;
+    heap.clear();
+
+    dist[source] = 0;
+    stamp[source] = epoch;
+    heap.pushOrDecrease(source, 0);
+    while (!heap.isEmpty()) {
+        IndexedHeap::Item item = heap.popMin();
+        int u = item.vertex;
+        if (u == target) {
+            heap.clear();
+            return potential ? originalDistance(source, target, item.priority) : item.priority;
+        }
+        for (long long i = offsets[u]; i < offsets[u + 1]; i++) {
+            int v = neighbors[i];
+            long long candidate = (long long)dist[u] + (weights ? weights[i] : 1);
+            if (candidate > 0x7fffffff) continue;
+            if (stamp[v] != epoch || candidate < dist[v]) {
+                stamp[v] = epoch;
+                dist[v] = (int)candidate;
+                heap.pushOrDecrease(v, dist[v]);
+            }
+        }
+    }
+    return DIST_INF;
+}
+
+} // namespace graph
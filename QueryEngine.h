@@ -0,0 +1,84 @@
+// michael9090124@gmail.com
+
+#ifndef QUERY_ENGINE_H
+#define QUERY_ENGINE_H
+
+#include "CSRGraph.h"
+#include "Algorithms.h"
+#include <atomic>
+
+namespace graph {
+
+class IndexedHeap;
+
+// Concurrent shortest path queries on one read-only graph.
+// The engine owns a CSRGraph and a pool of workspaces (queue, heap, distance scratch).
+// A query grabs a free workspace with one atomic exchange and returns it when done, so any
+// number of threads can query at the same time without locks. If every workspace is busy
+// the query allocates a temporary one instead of waiting.
+// Graphs with negative weights are reweighted once with Johnson potentials
+// (w + h[u] - h[v] >= 0), so their queries still run Dijkstra; the distances are
+// translated back on the way out.
+class QueryEngine {
+private:
+    struct alignas(64) Workspace {  // One cache line apart, so busy flags don't false-share
+        std::atomic<bool> busy;
+        bool temporary;             // Allocated because the pool was exhausted
+        IndexedHeap* heap;
+        int* queue;                 // bfs() queue, dijkstra() parent scratch with negative weights
+        int* dist;                  // Scratch distances for distance(), valid where stamp == epoch,
+                                    // and for dijkstra() with negative weights
+        unsigned int* stamp;
+        unsigned int epoch;
+
+        Workspace();
+        ~Workspace();
+        void init(int n);
+    };
+
+    CSRGraph graph;
+    bool negativeWeights;
+    int* potential;             // Johnson potentials, nullptr without negative weights
+    int* reducedWeights;        // w + h[u] - h[v] for every arc, nullptr without negative weights
+    Workspace* workspaces;
+    int numWorkspaces;
+
+    void reweight();
+    int originalDistance(int source, int target, int reduced) const;
+    const int* searchWeights() const { return reducedWeights ? reducedWeights : graph.getWeights(); }
+    Workspace* acquire() const;
+    void release(Workspace* ws) const;
+
+    struct Lease {                  // Returns the workspace on scope exit (also on throw)
+        const QueryEngine* engine;
+        Workspace* ws;
+        ~Lease() { engine->release(ws); }
+    };
+
+public:
+    // numWorkspaces = 0 uses one per hardware thread. Throws if the graph has a negative cycle.
+    explicit QueryEngine(CSRGraph&& g, int numWorkspaces = 0);
+    ~QueryEngine();
+    QueryEngine(const QueryEngine&) = delete;
+    QueryEngine& operator=(const QueryEngine&) = delete;
+
+    const CSRGraph& getGraph() const { return graph; }
+    int getNumWorkspaces() const { return numWorkspaces; }
+    bool hasNegativeWeights() const { return negativeWeights; }
+
+    // Hop counts from source into dist (n entries), -1 for unreachable vertices.
+    // Returns the number of reached vertices.
+    int bfs(int source, int* dist) const;
+    // Shortest path distances from source into dist (n entries), DIST_INF for unreachable
+    // vertices; parent (optional, n entries) receives the shortest path tree (-1 for roots
+    // and unreachable vertices). Throws if a distance does not fit in an int, leaving dist
+    // and parent unchanged.
+    int dijkstra(int source, int* dist, int* parent = nullptr) const;
+    // Distance from source to target (DIST_INF if unreachable). Stops as soon as target is
+    // settled and only touches the vertices it visits.
+    int distance(int source, int target) const;
+};
+
+}
+
+#endif
@@ -0,0 +1,309 @@
+// michael9090124@gmail.com
+
+#include "ThreadPool.h"
+
+namespace graph {
+
+// Chase-Lev work-stealing deque of packed index ranges (Le et al., "Correct and Efficient
+// Work-Stealing for Weak Memory Models"). The owner pushes and pops at the bottom, thieves
+// steal at the top. Ranges are only ever split in halves, so a deque holds a few dozen
+// entries at most and a fixed capacity is enough: when it is full, push fails and the owner
+// keeps the work.
+class RangeDeque {
+private:
+    static const long long CAPACITY = 64;
+    static const long long MASK = CAPACITY - 1;
+
+    alignas(64) std::atomic<long long> top;     // Next item to steal
+    alignas(64) std::atomic<long long> bottom;  // Next free slot (owner only)
+    std::atomic<unsigned long long> items[CAPACITY];
+
+public:
+    RangeDeque() : top(0), bottom(0) {}
+
+    long long size() const { // Estimate, exact for the owner when nobody steals
+        long long n = bottom.load(std::memory_order_relaxed) - top.load(std::memory_order_relaxed);
+        return n > 0 ? n : 0;
+    }
+
+    bool push(unsigned long long item) {
+        long long b = bottom.load(std::memory_order_relaxed);
+        long long t = top.load(std::memory_order_acquire);
+        if (b - t >= CAPACITY) {
+            return false;
+        }
+        items[b & MASK].store(item, std::memory_order_relaxed);
+        bottom.store(b + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(unsigned long long& item) {
+        long long b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_seq_cst);     // Claim the bottom item first
+        long long t = top.load(std::memory_order_seq_cst);
+        if (t > b) {                                    // Empty
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        item = items[b & MASK].load(std::memory_order_relaxed);
+        if (t == b) {                                   // Last item: race with thieves
+            bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                   std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    bool steal(unsigned long long& item) {
+        long long t = top.load(std::memory_order_seq_cst);
+        long long b = bottom.load(std::memory_order_seq_cst);
+        if (t >= b) {
+            return false;
+        }
+        item = items[t & MASK].load(std::memory_order_relaxed);
+        return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    void clear() { // Only when no other thread uses the deque
+        top.store(0, std::memory_order_relaxed);
+        bottom.store(0, std::memory_order_relaxed);
+    }
+};
+
+struct alignas(64) ThreadPool::Worker {
+    RangeDeque deque;
+    unsigned int seed;          // Victim selection (xorshift)
+};
+
+struct ThreadPool::Job {
+    RangeFunction fn;
+    void* context;
+    long long base;             // Ranges are packed relative to base (32 bits each)
+    const long long* prefix;    // Optional cost prefix, absolute indices
+    long long grain;            // Cost of one fn call
+    std::atomic<long long> remaining;   // Indices not processed yet
+    std::atomic<bool> failed;
+    const char* error;          // Written by the thread that set failed
+
+    long long cost(long long b, long long e) const {
+        return prefix ? (e - b) + (prefix[e] - prefix[b]) : e - b;
+    }
+
+    // Smallest m in [lo, e] with cost(b, m) >= target
+    long long costPoint(long long b, long long lo, long long e, long long target) const {
+        if (!prefix) {
+            long long m = b + target;
+            return m < lo ? lo : (m > e ? e : m);
+        }
+        long long hi = e;
+        while (lo < hi) {
+            long long mid = lo + (hi - lo) / 2;
+            if (cost(b, mid) >= target) hi = mid;
+            else lo = mid + 1;
+        }
+        return lo;
+    }
+
+    unsigned long long pack(long long b, long long e) const {
+        return ((unsigned long long)(b - base) << 32) | (unsigned long long)(e - base);
+    }
+};
+
+// Threads of any pool run nested loops serially
+static thread_local bool insidePool = false;
+
+ThreadPool::ThreadPool(int count)
+    : numThreads(count > 0 ? count : 1), job(nullptr), generation(0), activeHelpers(0),
+      stopping(false), busy(false) {
+    workers = new Worker[numThreads];
+    for (int i = 0; i < numThreads; i++) {
+        workers[i].seed = 2463534242u + 977u * (unsigned int)i;
+    }
+    threads = new std::thread[numThreads > 1 ? numThreads - 1 : 1];
+    for (int i = 1; i < numThreads; i++) {
+        threads[i - 1] = std::thread(&ThreadPool::helperLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (int i = 1; i < numThreads; i++) {
+        threads[i - 1].join();
+    }
+    delete[] threads;
+    delete[] workers;
+}
+
+void ThreadPool::helperLoop(int index) {
+    insidePool = true;
+    unsigned long long seen = 0;
+    while (true) {
+        Job* current;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || (job != nullptr && generation != seen); });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+            current = job;
+            activeHelpers++;
+        }
+        work(index, *current);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            activeHelpers--;
+        }
+        finished.notify_all();
+    }
+}
+
+// Walk [b, e) in grain-cost pieces, splitting off the upper half whenever the own deque is empty
+bool ThreadPool::processRange(int index, Job& j, long long b, long long e) {
+    RangeDeque& deque = workers[index].deque;
+    long long done = 0;
+    while (b < e && !j.failed.load(std::memory_order_relaxed)) {
+        if (e - b >= 2 && deque.size() == 0) {
+            long long total = j.cost(b, e);
+            if (total > 2 * j.grain) {
+                long long mid = j.costPoint(b, b + 1, e - 1, total / 2);
+                if (deque.push(j.pack(mid, e))) e = mid;
+            }
+        }
+        long long pieceEnd = j.costPoint(b, b + 1, e, j.grain);
+        if (pieceEnd - b > 1 && j.cost(b, pieceEnd) > 2 * j.grain) {
+            pieceEnd--;     // The last vertex is a hub: leave it for a piece of its own
+        }
+        try {
+            j.fn(j.context, b, pieceEnd);
+        } catch (const char* message) {
+            if (!j.failed.exchange(true)) j.error = message;
+        } catch (...) {
+            if (!j.failed.exchange(true)) j.error = "Exception in parallel loop!";
+        }
+        done += pieceEnd - b;
+        b = pieceEnd;
+    }
+    j.remaining.fetch_sub(done, std::memory_order_acq_rel);
+    return !j.failed.load(std::memory_order_relaxed);
+}
+
+void ThreadPool::work(int index, Job& j) {
+    Worker& self = workers[index];
+    unsigned long long item;
+    while (j.remaining.load(std::memory_order_acquire) > 0 && !j.failed.load(std::memory_order_relaxed)) {
+        bool found = self.deque.pop(item);
+        if (!found && numThreads > 1) { // Steal, starting at a random victim
+            self.seed ^= self.seed << 13;
+            self.seed ^= self.seed >> 17;
+            self.seed ^= self.seed << 5;
+            int start = (int)(self.seed % (unsigned int)numThreads);
+            for (int k = 0; k < numThreads && !found; k++) {
+                int victim = (start + k) % numThreads;
+                if (victim != index) found = workers[victim].deque.steal(item);
+            }
+        }
+        if (found) {
+            processRange(index, j, j.base + (long long)(item >> 32), j.base + (long long)(item & 0xffffffffULL));
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void ThreadPool::run(RangeFunction fn, void* context, long long begin, long long end,
+                     const long long* costPrefix, long long grain) {
+    if (end <= begin) {
+        return;
+    }
+    // Single thread, nested loop or another loop in progress: run serially
+    if (numThreads == 1 || insidePool || busy.exchange(true)) {
+        fn(context, begin, end);
+        return;
+    }
+    const long long MAX_JOB = 0xffffffffLL;     // Packed ranges hold 32-bit offsets
+    insidePool = true;
+    for (long long jobBegin = begin; jobBegin < end; jobBegin += MAX_JOB) {
+        long long jobEnd = end - jobBegin > MAX_JOB ? jobBegin + MAX_JOB : end;
+        Job j;
+        j.fn = fn;
+        j.context = context;
+        j.base = jobBegin;
+        j.prefix = costPrefix;
+        j.remaining.store(jobEnd - jobBegin);
+        j.failed.store(false);
+        j.error = nullptr;
+        j.grain = grain;
+        if (j.grain <= 0) { // About 64 pieces per thread
+            j.grain = j.cost(jobBegin, jobEnd) / ((long long)numThreads * 64);
+            if (j.grain < 16) j.grain = 16;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &j;
+            generation++;
+        }
+        wake.notify_all();
+        processRange(0, j, jobBegin, jobEnd);   // The caller starts with the whole range
+        work(0, j);
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            job = nullptr;
+            finished.wait(lock, [&] { return activeHelpers == 0; });
+        }
+        if (j.failed.load()) {
+            for (int i = 0; i < numThreads; i++) {
+                workers[i].deque.clear();   // Drop the ranges nobody processed
+            }
+            insidePool = false;
+            busy.store(false);
+            throw j.error;
+        }
+    }
+    insidePool = false;
+    busy.store(false);
+}
+
+// Default pool, rebuilt when the thread count changes
+static std::mutex defaultPoolMutex;
+static ThreadPool* defaultPool = nullptr;
+static std::atomic<int> requestedThreads(0);
+
+struct DefaultPoolOwner {      // Joins the helper threads at exit
+    ~DefaultPoolOwner() {
+        delete defaultPool;
+        defaultPool = nullptr;
+    }
+};
+static DefaultPoolOwner defaultPoolOwner;
+
+void setNumThreads(int threads) {
+    std::lock_guard<std::mutex> lock(defaultPoolMutex);
+    requestedThreads.store(threads > 0 ? threads : 0);
+    if (defaultPool != nullptr && defaultPool->size() != getNumThreads()) {
+        delete defaultPool;
+        defaultPool = nullptr;
+    }
+}
+
+int getNumThreads() {
+    int threads = requestedThreads.load();
+    if (threads <= 0) threads = (int)std::thread::hardware_concurrency();
+    return threads > 0 ? threads : 1;
+}
+
+ThreadPool& defaultThreadPool() {
+    std::lock_guard<std::mutex> lock(defaultPoolMutex);
+    if (defaultPool == nullptr) {
+        defaultPool = new ThreadPool(getNumThreads());
+    }
+    return *defaultPool;
+}
+
+} // namespace graph
@@ -0,0 +1,90 @@
+// michael9090124@gmail.com
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace graph {
+
+// Number of threads used by parallel loops (including the calling thread).
+// 0 = one per hardware thread. Takes effect at the next parallel loop; do not call it
+// while a parallel loop is running.
+void setNumThreads(int threads);
+int getNumThreads();
+
+// Body of a parallel loop: processes the indices [begin, end)
+typedef void (*RangeFunction)(void* context, long long begin, long long end);
+
+// Work-stealing thread pool.
+// Every worker owns a Chase-Lev deque of index ranges. A worker walks its range in pieces of
+// 'grain' cost and, whenever its deque is empty (thieves took everything), splits the rest of
+// its range in half and pushes the upper half for others to steal. Splitting therefore only
+// happens when there is demand, and idle workers steal from random victims.
+// With a cost prefix (e.g. CSR offsets), ranges are split and cut into pieces by cost
+// instead of by count, so a high degree vertex gets a piece of its own.
+class ThreadPool {
+private:
+    struct Worker;
+    struct Job;
+
+    int numThreads;
+    Worker* workers;            // numThreads entries, worker 0 is the calling thread
+    std::thread* threads;       // numThreads - 1 helper threads
+
+    std::mutex mutex;
+    std::condition_variable wake;       // New job or shutdown
+    std::condition_variable finished;   // A helper left the current job
+    Job* job;                   // Current job, nullptr when idle
+    unsigned long long generation;
+    int activeHelpers;
+    bool stopping;
+    std::atomic<bool> busy;     // A loop is running (nested / concurrent loops run serially)
+
+    void helperLoop(int index);
+    void work(int index, Job& j);
+    bool processRange(int index, Job& j, long long begin, long long end);
+
+public:
+    explicit ThreadPool(int threads);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const { return numThreads; }
+
+    // Calls fn(context, b, e) on disjoint subranges that cover [begin, end) and returns when
+    // all of them are done. costPrefix (optional) gives the cost of index i as
+    // costPrefix[i + 1] - costPrefix[i] (absolute indices); grain is the target cost of one
+    // call (0 = automatic). A const char* thrown by fn is rethrown on the calling thread.
+    void run(RangeFunction fn, void* context, long long begin, long long end,
+             const long long* costPrefix = nullptr, long long grain = 0);
+};
+
+// Pool shared by the library, sized by setNumThreads
+ThreadPool& defaultThreadPool();
+
+template <class Body>
+void callRangeBody(void* context, long long begin, long long end) {
+    (*static_cast<const Body*>(context))(begin, end);
+}
+
+// body(begin, end) over subranges of [begin, end)
+template <class Body>
+void parallel_for(long long begin, long long end, const Body& body, long long grain = 0) {
+    defaultThreadPool().run(&callRangeBody<Body>, (void*)&body, begin, end, nullptr, grain);
+}
+
+// Degree-aware variant: the cost of vertex v is offsets[v + 1] - offsets[v] plus one
+template <class Body>
+void parallel_for_weighted(long long begin, long long end, const long long* offsets, const Body& body,
+                           long long grain = 0) {
+    defaultThreadPool().run(&callRangeBody<Body>, (void*)&body, begin, end, offsets, grain);
+}
+
+}
+
+#endif
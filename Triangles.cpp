@@ -0,0 +1,277 @@
+// michael9090124@gmail.com
+
+#include "Triangles.h"
+#include "Graph.h"
+#include "CSRGraph.h"
+#include "CompressedGraph.h"
+#include "ThreadPool.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace graph {
+
+// Simple undirected graph with every edge oriented from its lower ranked endpoint
+struct OrientedGraph {
+    int n;
+    long long* offsets;     // Out-neighbors of u: neighbors[offsets[u] .. offsets[u + 1]), sorted
+    int* neighbors;
+    int* degree;            // Undirected degree (out + in)
+
+    template <class GraphT>
+    explicit OrientedGraph(const GraphT& g) : n(g.getNumVertices()) {
+        int size = n > 0 ? n : 1;
+        degree = new int[size];
+        for (int u = 0; u < n; u++) {
+            degree[u] = g.getSize(u);       // Raw degree, only used to rank the vertices
+        }
+        auto lower = [&](int u, int v) {
+            return degree[u] < degree[v] || (degree[u] == degree[v] && u < v);
+        };
+
+        // Orient every arc (both directions of an edge give the same oriented arc)
+        long long arcs = 0;
+        for (int u = 0; u < n; u++) {
+            arcs += degree[u];
+        }
+        int* arcSrc = new int[arcs > 0 ? arcs : 1];
+        int* arcDst = new int[arcs > 0 ? arcs : 1];
+        long long numArcs = 0;
+        for (int u = 0; u < n; u++) {
+            for (Edge e : g.edges(u)) {
+                if (e.dst == u) continue;
+                bool forward = lower(u, e.dst);
+                arcSrc[numArcs] = forward ? u : e.dst;
+                arcDst[numArcs++] = forward ? e.dst : u;
+            }
+        }
+
+        // Stable counting sort by destination, then by source: lists end up sorted
+        long long* count = new long long[size + 1];
+        int* byDst = new int[numArcs > 0 ? numArcs : 1];    // Arc indices sorted by destination
+        for (int v = 0; v <= n; v++) count[v] = 0;
+        for (long long i = 0; i < numArcs; i++) count[arcDst[i] + 1]++;
+        for (int v = 0; v < n; v++) count[v + 1] += count[v];
+        for (long long i = 0; i < numArcs; i++) byDst[count[arcDst[i]]++] = (int)i;
+
+        offsets = new long long[size + 1];
+        for (int v = 0; v <= n; v++) offsets[v] = 0;
+        for (long long i = 0; i < numArcs; i++) offsets[arcSrc[i] + 1]++;
+        for (int v = 0; v < n; v++) offsets[v + 1] += offsets[v];
+        for (int v = 0; v < n; v++) count[v] = offsets[v];
+        neighbors = new int[numArcs > 0 ? numArcs : 1];
+        for (long long k = 0; k < numArcs; k++) {
+            int i = byDst[k];
+            neighbors[count[arcSrc[i]]++] = arcDst[i];
+        }
+        delete[] byDst;
+        delete[] count;
+        delete[] arcSrc;
+        delete[] arcDst;
+
+        // Drop parallel arcs (adjacent after sorting) and compact the lists
+        long long out = 0;
+        for (int u = 0; u < n; u++) {
+            long long first = offsets[u];
+            offsets[u] = out;
+            for (long long i = first; i < offsets[u + 1]; i++) {
+                if (out == offsets[u] || neighbors[out - 1] != neighbors[i]) neighbors[out++] = neighbors[i];
+            }
+        }
+        if (n > 0) offsets[n] = out;
+
+        for (int u = 0; u < n; u++) {
+            degree[u] = 0;
+        }
+        for (int u = 0; u < n; u++) {
+            degree[u] += (int)(offsets[u + 1] - offsets[u]);
+            for (long long i = offsets[u]; i < offsets[u + 1]; i++) {
+                degree[neighbors[i]]++;
+            }
+        }
+    }
+
+    ~OrientedGraph() {
+        delete[] offsets;
+        delete[] neighbors;
+        delete[] degree;
+    }
+
+    OrientedGraph(const OrientedGraph&) = delete;
+    OrientedGraph& operator=(const OrientedGraph&) = delete;
+};
+
+// |a ∩ b| for sorted lists of distinct values, calling found(w) for every common w if Report
+template <bool Report, class Found>
+static long long mergeIntersect(const int* a, int na, const int* b, int nb, const Found& found) {
+    long long count = 0;
+    int i = 0, j = 0;
+#ifdef __AVX2__
+    // Compare 8 values of a with 8 values of b (b rotated 7 times), then drop the block
+    // with the smaller maximum (its values can't match anything further on)
+    const __m256i rotate = _mm256_set_epi32(0, 7, 6, 5, 4, 3, 2, 1);
+    while (i + 8 <= na && j + 8 <= nb) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + j));
+        __m256i equal = _mm256_cmpeq_epi32(va, vb);
+        for (int r = 1; r < 8; r++) {
+            vb = _mm256_permutevar8x32_epi32(vb, rotate);
+            equal = _mm256_or_si256(equal, _mm256_cmpeq_epi32(va, vb));
+        }
+        unsigned int mask = (unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(equal));
+        count += __builtin_popcount(mask);
+        if (Report) {
+            for (; mask != 0; mask &= mask - 1) found(a[i + __builtin_ctz(mask)]);
+        }
+        int maxA = a[i + 7], maxB = b[j + 7];
+        if (maxA <= maxB) i += 8;
+        if (maxB <= maxA) j += 8;
+    }
+#endif
+    while (i < na && j < nb) {
+        if (a[i] < b[j]) {
+            i++;
+        } else if (a[i] > b[j]) {
+            j++;
+        } else {
+            if (Report) found(a[i]);
+            count++;
+            i++;
+            j++;
+        }
+    }
+    return count;
+}
+
+// Same, for a much shorter than b: exponential then binary search for every value of a
+template <bool Report, class Found>
+static long long gallopIntersect(const int* a, int na, const int* b, int nb, const Found& found) {
+    long long count = 0;
+    int j = 0;                      // b[0 .. j) < the current value of a
+    for (int i = 0; i < na && j < nb; i++) {
+        int x = a[i];
+        int lo = j, step = 1;
+        while (lo + step < nb && b[lo + step] < x) {
+            lo += step;
+            step *= 2;
+        }
+        int hi = lo + step < nb ? lo + step : nb;
+        while (lo < hi) {
+            int mid = lo + (hi - lo) / 2;
+            if (b[mid] < x) lo = mid + 1;
+            else hi = mid;
+        }
+        j = lo;
+        if (j < nb && b[j] == x) {
+            if (Report) found(x);
+            count++;
+            j++;
+        }
+    }
+    return count;
+}
+
+static const int GALLOP_RATIO = 32;  // Gallop when one list is this many times longer
+
+template <bool Report, class Found>
+static long long intersect(const int* a, int na, const int* b, int nb, const Found& found) {
+    if (na > nb) {
+        const int* t = a; a = b; b = t;
+        int nt = na; na = nb; nb = nt;
+    }
+    if (na == 0) return 0;
+    if ((long long)nb > (long long)GALLOP_RATIO * na) return gallopIntersect<Report>(a, na, b, nb, found);
+    return mergeIntersect<Report>(a, na, b, nb, found);
+}
+
+// Triangle count of og; adds every vertex's count to perVertex when Report
+template <bool Report>
+static long long countOriented(const OrientedGraph& og, std::atomic<long long>* perVertex) {
+    const long long* offsets = og.offsets;
+    const int* neighbors = og.neighbors;
+    std::atomic<long long> total(0);
+    parallel_for_weighted(0, og.n, offsets, [&](long long begin, long long end) {
+        long long local = 0;
+        auto found = [&](int w) { perVertex[w].fetch_add(1, std::memory_order_relaxed); };
+        for (long long u = begin; u < end; u++) {
+            const int* a = neighbors + offsets[u];
+            int na = (int)(offsets[u + 1] - offsets[u]);
+            long long atU = 0;
+            for (int k = 0; k < na; k++) {
+                int v = a[k];
+                const int* b = neighbors + offsets[v];
+                long long common = intersect<Report>(a, na, b, (int)(offsets[v + 1] - offsets[v]), found);
+                if (Report && common > 0) perVertex[v].fetch_add(common, std::memory_order_relaxed);
+                atU += common;
+            }
+            if (Report && atU > 0) perVertex[u].fetch_add(atU, std::memory_order_relaxed);
+            local += atU;
+        }
+        total.fetch_add(local);
+    });
+    return total.load();
+}
+
+// Counts with per-vertex results written to perVertex
+static long long countPerVertex(const OrientedGraph& og, long long* perVertex) {
+    int n = og.n;
+    std::atomic<long long>* counts = new std::atomic<long long>[n > 0 ? n : 1];
+    for (int v = 0; v < n; v++) {
+        counts[v].store(0, std::memory_order_relaxed);
+    }
+    long long total;
+    try {
+        total = countOriented<true>(og, counts);
+    } catch (...) {
+        delete[] counts;
+        throw;
+    }
+    for (int v = 0; v < n; v++) {
+        perVertex[v] = counts[v].load(std::memory_order_relaxed);
+    }
+    delete[] counts;
+    return total;
+}
+
+template <class GraphT>
+long long countTriangles(const GraphT& g, long long* perVertex) {
+    OrientedGraph og(g);
+    if (perVertex) return countPerVertex(og, perVertex);
+    return countOriented<false>(og, nullptr);
+}
+
+template <class GraphT>
+double clusteringCoefficients(const GraphT& g, double* coefficients) {
+    OrientedGraph og(g);
+    int n = og.n;
+    long long* triangles = new long long[n > 0 ? n : 1];
+    try {
+        countPerVertex(og, triangles);
+    } catch (...) {
+        delete[] triangles;
+        throw;
+    }
+    double sum = 0.0;
+    for (int v = 0; v < n; v++) {
+        long long d = og.degree[v];
+        coefficients[v] = d < 2 ? 0.0 : 2.0 * triangles[v] / (double)(d * (d - 1));
+        sum += coefficients[v];
+    }
+    delete[] triangles;
+    return n > 0 ? sum / n : 0.0;
+}
+
+// Explicit instantiations for the supported graph storages
+template long long countTriangles<Graph>(const Graph&, long long*);
+template long long countTriangles<UnweightedGraph>(const UnweightedGraph&, long long*);
+template long long countTriangles<InterleavedGraph>(const InterleavedGraph&, long long*);
+template long long countTriangles<CSRGraph>(const CSRGraph&, long long*);
+template long long countTriangles<CompressedGraph>(const CompressedGraph&, long long*);
+template double clusteringCoefficients<Graph>(const Graph&, double*);
+template double clusteringCoefficients<UnweightedGraph>(const UnweightedGraph&, double*);
+template double clusteringCoefficients<InterleavedGraph>(const InterleavedGraph&, double*);
+template double clusteringCoefficients<CSRGraph>(const CSRGraph&, double*);
+template double clusteringCoefficients<CompressedGraph>(const CompressedGraph&, double*);
+
+} // namespace graph
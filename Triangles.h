@@ -0,0 +1,30 @@
+// michael9090124@gmail.com
+
+#ifndef TRIANGLES_H
+#define TRIANGLES_H
+
+namespace graph {
+
+// Triangle counting on g viewed as a simple undirected graph (edge directions, weights,
+// parallel edges and self-loops are ignored).
+// Every edge is oriented from the endpoint of lower degree to the other one (ties by id)
+// into a CSR whose lists are sorted by two counting sorts, so every vertex keeps at most
+// O(sqrt m) out-neighbors. A triangle is then found exactly once, from its lowest vertex u
+// and middle vertex v, as an element of N+(u) ∩ N+(v). Lists of similar sizes are merged
+// (8x8 AVX2 block compares when built with make AVX2=1), and when one list is more than 32
+// times longer the short one gallops through it. Vertices are split among the threads by
+// their oriented degree. O(m^1.5) time, O(n + m) extra space.
+
+// Returns the number of triangles. perVertex (optional) receives, for every vertex, the
+// number of triangles it belongs to.
+template <class GraphT>
+long long countTriangles(const GraphT& g, long long* perVertex = nullptr);
+
+// coefficients[v] = triangles(v) / (d(v) (d(v) - 1) / 2), 0 when d(v) < 2 (d = simple degree).
+// Returns the average local clustering coefficient over all vertices.
+template <class GraphT>
+double clusteringCoefficients(const GraphT& g, double* coefficients);
+
+}
+
+#endif
@@ -0,0 +1,598 @@
+// michael9090124@gmail.com
+
+// Benchmark harness: runs graph construction and every algorithm over generated graphs,
+// repeats each run, and reports median / p95 time, edges per second (TEPS) and peak RSS.
+// Results are printed as a table and written as JSON (for tracking regressions across builds).
+//
+// Usage: ./bench.exe [--scale S] [--edge-factor K] [--reps R] [--seed X]
+//                    [--graphs rmat,er,grid,ba,rgg] [--out bench.json] [--perf] [--queues] [--parse]
+// --perf adds hardware counters (cycles, instructions, LLC and dTLB misses) per vertex and
+// per edge, averaged over the repetitions.
+// --queues also measures queue throughput: the lock-free MPMCQueue (single and batched
+// operations) against a mutex-guarded Queue, with 1, 2 and 4 producer / consumer pairs
+// moving 2^(S+10) items (the "teps" column is then items per second).
+// --parse also measures edge list parsing: an R-MAT graph with 2^(S+6) vertices written as
+// SNAP text in memory, parsed into a GraphBuilder with 1, 2, 4, ... up to the hardware
+// thread count (the "teps" column is then bytes per second, MTEPS = MB/s).
+// Graphs have 2^S vertices and about K * 2^S edges. Kruskal and Prim are quadratic in
+// places, so keep S small (the default is 10) when running all algorithms.
+
+#include "Graph.h"
+#include "Algorithms.h"
+#include "CSRGraph.h"
+#include "CompressedGraph.h"
+#include "GraphBuilder.h"
+#include "GraphIO.h"
+#include "Generators.h"
+#include "PerfCounters.h"
+#include "DataStructures.h"
+#include "QueryEngine.h"
+#include "APSP.h"
+#include "DynamicSSSP.h"
+#include "DynamicMST.h"
+#include "DynamicConnectivity.h"
+#include "OfflineConnectivity.h"
+#include "PageRank.h"
+#include "Triangles.h"
+#include "KCore.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/resource.h>
+
+using namespace graph;
+
+struct Config {
+    int scale = 10;
+    int edgeFactor = 8;
+    int reps = 5;
+    unsigned long long seed = 1;
+    std::string graphs = "rmat,er,grid,ba,rgg";
+    std::string out = "bench.json";
+    bool perf = false;
+    bool queues = false;
+    bool parse = false;
+};
+
+struct Result {
+    std::string graph;
+    std::string layout;
+    std::string algorithm;
+    int vertices;
+    long long edges;            // Undirected edges processed by one run
+    double medianMs;
+    double p95Ms;
+    double teps;                // edges / median time
+    long peakRssKb;             // Peak RSS of the process after this benchmark
+    PerfCounts counts;          // Average per run, -1 if not measured / unavailable
+};
+
+// Hardware counters of the main thread, opened once when --perf is given
+static PerfCounters* counters = nullptr;
+
+static long peakRssKb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss; // Kilobytes on Linux
+}
+
+// Time fn reps times and record median / p95 (nearest rank).
+// An algorithm that throws (e.g. kruskal on a disconnected graph) is reported and skipped.
+template <class Fn>
+static void measure(std::vector<Result>& results, const Config& config, const std::string& graphName,
+                    const char* layout, const char* algorithm, int vertices, long long edges, Fn fn) {
+    std::vector<double> times;
+    long long totals[4] = {0, 0, 0, 0};
+    for (int r = 0; r < config.reps; r++) {
+        if (counters != nullptr) counters->start();
+        auto start = std::chrono::steady_clock::now();
+        try {
+            fn();
+        } catch (const char* e) {
+            std::printf("%-5s %-12s %-16s skipped: %s\n", graphName.c_str(), layout, algorithm, e);
+            return;
+        }
+        auto end = std::chrono::steady_clock::now();
+        times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        if (counters != nullptr) {
+            PerfCounts counts = counters->stop();
+            long long values[4] = {counts.cycles, counts.instructions, counts.llcMisses, counts.dtlbMisses};
+            for (int i = 0; i < 4; i++) {
+                totals[i] = (values[i] < 0 || totals[i] < 0) ? -1 : totals[i] + values[i];
+            }
+        }
+    }
+    std::sort(times.begin(), times.end());
+    Result result;
+    result.graph = graphName;
+    result.layout = layout;
+    result.algorithm = algorithm;
+    result.vertices = vertices;
+    result.edges = edges;
+    result.medianMs = times[times.size() / 2];
+    result.p95Ms = times[(size_t)std::ceil(0.95 * times.size()) - 1];
+    result.teps = result.medianMs > 0 ? edges / (result.medianMs / 1000.0) : 0;
+    result.peakRssKb = peakRssKb();
+    long long* averages[4] = {&result.counts.cycles, &result.counts.instructions,
+                              &result.counts.llcMisses, &result.counts.dtlbMisses};
+    for (int i = 0; i < 4; i++) {
+        *averages[i] = (counters != nullptr && totals[i] >= 0) ? totals[i] / config.reps : -1;
+    }
+    std::printf("%-5s %-12s %-16s %9.3f ms  p95 %9.3f ms  %8.2f MTEPS  rss %ld KB\n",
+                graphName.c_str(), layout, algorithm, result.medianMs, result.p95Ms,
+                result.teps / 1e6, result.peakRssKb);
+    if (counters != nullptr && counters->available()) {
+        PerfSample sample = {algorithm, vertices, edges, result.counts};
+        printPerfSample(sample, stdout);
+    }
+    results.push_back(result);
+}
+
+// JSON value of a counter normalized by count (null when unavailable)
+static void writeRatio(FILE* f, const char* key, long long value, long long count, bool last) {
+    if (value < 0 || count <= 0) {
+        std::fprintf(f, "\"%s\": null%s", key, last ? "" : ", ");
+    } else {
+        std::fprintf(f, "\"%s\": %.4f%s", key, (double)value / count, last ? "" : ", ");
+    }
+}
+
+static void generate(GraphBuilder& builder, const std::string& name, const Config& config) {
+    int n = 1 << config.scale;
+    if (name == "rmat") {
+        generateRMAT(builder, config.scale, config.edgeFactor, config.seed, 100);
+    } else if (name == "er") {
+        generateErdosRenyi(builder, n, (long long)config.edgeFactor * n, config.seed, 100);
+    } else if (name == "grid") {
+        int side = (int)std::sqrt((double)n);
+        generateGrid(builder, side, n / side, config.seed, 100);
+    } else if (name == "ba") {
+        generateBarabasiAlbert(builder, n, config.edgeFactor, config.seed, 100);
+    } else if (name == "rgg") { // Expected degree about 2 * edgeFactor
+        double radius = std::sqrt(2.0 * config.edgeFactor / (3.14159265358979 * n));
+        generateRandomGeometric(builder, n, radius, config.seed);
+    } else {
+        throw "Unknown graph generator!";
+    }
+}
+
+// Traversals over one storage layout (every layout exposes edges(v))
+template <class GraphT>
+static void benchLayout(std::vector<Result>& results, const Config& config, const std::string& graphName,
+                        const char* layout, GraphT& g, int source, long long edges) {
+    BasicAlgorithms<GraphT> alg(g);
+    int n = g.getNumVertices();
+    std::vector<int> component(n);
+    measure(results, config, graphName, layout, "bfs", n, edges, [&] { alg.bfs(source); });
+    measure(results, config, graphName, layout, "components", n, edges,
+            [&] { alg.connectedComponents(component.data()); });
+}
+
+static void benchGraph(std::vector<Result>& results, const Config& config, const std::string& name) {
+    GraphBuilder builder;
+    generate(builder, name, config);
+    int n = builder.getNumVertices();
+
+    // Construction
+    measure(results, config, name, "builder", "build_csr", n, builder.getNumEdges(),
+            [&] { builder.buildCSR(); });
+    measure(results, config, name, "builder", "build_graph", n, builder.getNumEdges(),
+            [&] { builder.buildGraph<Weighted>(); });
+    CSRGraph csr = builder.buildCSR();
+    long long edges = csr.getNumEdges() / 2;
+    measure(results, config, name, "adjacency", "add_edge", n, edges, [&] {
+        Graph g(n);
+        for (int u = 0; u < n; u++) {
+            for (Edge e : csr.edges(u)) {
+                if (u < e.dst) g.addEdge(u, e.dst, e.w);
+            }
+        }
+    });
+
+    // Source: the highest degree vertex (vertex 0 may be isolated in random graphs)
+    int source = 0;
+    for (int v = 0; v < n; v++) {
+        if (csr.getSize(v) > csr.getSize(source)) source = v;
+    }
+
+    // Every algorithm on the default weighted adjacency lists (bfs is in the layout comparison)
+    Graph g = builder.buildGraph<Weighted>();
+    Algorithms alg(g);
+    measure(results, config, name, "adjacency", "dfs", n, edges, [&] { alg.dfs(source); });
+    measure(results, config, name, "adjacency", "dijkstra", n, edges, [&] { alg.dijkstra(source); });
+    measure(results, config, name, "adjacency", "prim", n, edges, [&] { alg.prim(); });
+    measure(results, config, name, "adjacency", "kruskal", n, edges, [&] { alg.kruskal(); });
+
+    // 64 shortest path queries: one batch against one query at a time (indexed heap, CSR)
+    const int QUERIES = 64;
+    std::vector<int> sources(QUERIES);
+    for (int q = 0; q < QUERIES; q++) {
+        sources[q] = (int)((q * 2654435761u) % (unsigned int)n);
+    }
+    std::vector<int> distances((size_t)QUERIES * n);
+    BasicAlgorithms<CSRGraph> csrAlg(csr);
+    QueryEngine engine(builder.buildCSR(), 1);
+    measure(results, config, name, "csr", "dijkstra_batch64", n, edges * QUERIES,
+            [&] { csrAlg.dijkstraBatch(sources.data(), QUERIES, distances.data()); });
+    measure(results, config, name, "csr", "dijkstra_seq64", n, edges * QUERIES, [&] {
+        for (int q = 0; q < QUERIES; q++) {
+            engine.dijkstra(sources[q], distances.data() + (size_t)q * n);
+        }
+    });
+
+    measure(results, config, name, "csr", "bellman_ford", n, edges,
+            [&] { csrAlg.bellmanFord(source, distances.data()); });
+
+    // Edge updates with distances from source kept fresh: repair against a search per update.
+    // Every update removes an edge and puts it back, so each repetition sees the same graph.
+    const int UPDATES = 256;
+    std::vector<int> updateU, updateV, updateW;
+    for (int i = 0; updateU.size() < (size_t)UPDATES && i < 64 * UPDATES; i++) {
+        int u = (int)((i * 2654435761u) % (unsigned int)n);
+        if (g.getSize(u) == 0) continue;
+        updateU.push_back(u);
+        updateV.push_back(g.neighborAt(u, 0));
+        updateW.push_back(g.weightAt(u, 0));
+    }
+    Graph observed = g;
+    DynamicSSSP sssp(observed, source);
+    measure(results, config, name, "adjacency", "sssp_dynamic", n, edges * (long long)updateU.size(), [&] {
+        for (size_t i = 0; i < updateU.size(); i++) {
+            observed.removeEdge(updateU[i], updateV[i]);
+            observed.addEdge(updateU[i], updateV[i], updateW[i]);
+        }
+    });
+    Graph plain = g;
+    BasicAlgorithms<Graph> plainAlg(plain);
+    measure(results, config, name, "adjacency", "sssp_recompute", n, edges * (long long)updateU.size(), [&] {
+        for (size_t i = 0; i < updateU.size(); i++) {
+            plain.removeEdge(updateU[i], updateV[i]);
+            plainAlg.dijkstraBatch(&source, 1, distances.data());
+            plain.addEdge(updateU[i], updateV[i], updateW[i]);
+            plainAlg.dijkstraBatch(&source, 1, distances.data());
+        }
+    });
+
+    // The same updates with a minimum spanning forest kept fresh: repair against a rebuild
+    // (DynamicMST's own construction, O(m log n): prim and kruskal need connected graphs)
+    Graph forestGraph = g;
+    DynamicMST mst(forestGraph);
+    measure(results, config, name, "adjacency", "mst_dynamic", n, edges * (long long)updateU.size(), [&] {
+        for (size_t i = 0; i < updateU.size(); i++) {
+            forestGraph.removeEdge(updateU[i], updateV[i]);
+            forestGraph.addEdge(updateU[i], updateV[i], updateW[i]);
+        }
+    });
+    const size_t REBUILDS = updateU.size() < 32 ? updateU.size() : 32;  // Rebuilds are slow: fewer updates
+    measure(results, config, name, "adjacency", "mst_rebuild", n, edges * (long long)REBUILDS, [&] {
+        for (size_t i = 0; i < REBUILDS; i++) {
+            plain.removeEdge(updateU[i], updateV[i]);
+            { DynamicMST rebuilt(plain); }
+            plain.addEdge(updateU[i], updateV[i], updateW[i]);
+            { DynamicMST rebuilt(plain); }
+        }
+    });
+
+    // Connectivity queries between the updates: dynamic index against relabeling components
+    Graph connectedGraph = g;
+    DynamicConnectivity connectivity(connectedGraph);
+    measure(results, config, name, "adjacency", "conn_dynamic", n, edges * (long long)updateU.size(), [&] {
+        for (size_t i = 0; i < updateU.size(); i++) {
+            connectedGraph.removeEdge(updateU[i], updateV[i]);
+            connectivity.connected(updateU[i], updateV[i]);
+            connectedGraph.addEdge(updateU[i], updateV[i], updateW[i]);
+            connectivity.connected(updateU[i], sources[i % QUERIES]);
+        }
+    });
+    measure(results, config, name, "adjacency", "conn_recompute", n, edges * (long long)updateU.size(), [&] {
+        for (size_t i = 0; i < updateU.size(); i++) {
+            plain.removeEdge(updateU[i], updateV[i]);
+            plainAlg.connectedComponents(distances.data());    // Labels answer the query
+            plain.addEdge(updateU[i], updateV[i], updateW[i]);
+            plainAlg.connectedComponents(distances.data());
+        }
+    });
+
+    // The same updates and queries known in advance, answered offline
+    std::vector<OfflineOp> ops;
+    for (size_t i = 0; i < updateU.size(); i++) {
+        ops.push_back({OFFLINE_REMOVE, updateU[i], updateV[i]});
+        ops.push_back({OFFLINE_CONNECTED, updateU[i], updateV[i]});
+        ops.push_back({OFFLINE_ADD, updateU[i], updateV[i]});
+        ops.push_back({OFFLINE_CONNECTED, updateU[i], sources[i % QUERIES]});
+    }
+    measure(results, config, name, "adjacency", "conn_offline", n, edges * (long long)updateU.size(),
+            [&] { offlineConnectivity(g, ops.data(), (int)ops.size(), distances.data()); });
+
+    // PageRank, pull-based over the transpose of the CSR (one SpMV per iteration)
+    PageRank pageRank(csr);
+    std::vector<float> rank(n);
+    measure(results, config, name, "csr", "pagerank", n, edges * 20,
+            [&] { pageRank.run(rank.data(), 0.85f, 0.0f, 20); });
+
+    // Triangles over the degree-oriented, sorted lists (includes building them)
+    measure(results, config, name, "csr", "triangles", n, edges, [&] { countTriangles(csr); });
+    std::vector<double> coefficients(n);
+    measure(results, config, name, "csr", "clustering", n, edges,
+            [&] { clusteringCoefficients(csr, coefficients.data()); });
+
+    // k-core decomposition: sequential bin sort vs parallel peeling
+    std::vector<int> coreNumbers(n);
+    measure(results, config, name, "csr", "kcore", n, edges,
+            [&] { coreDecomposition(csr, coreNumbers.data(), distances.data()); });
+    measure(results, config, name, "csr", "kcore_parallel", n, edges,
+            [&] { parallelCoreDecomposition(csr, coreNumbers.data(), distances.data()); });
+
+    // All-pairs shortest paths, both backends (n^2 matrix: small graphs only)
+    if (n <= 8192) {
+        std::vector<int> matrix((size_t)n * n);
+        measure(results, config, name, "csr", "apsp_floyd", n, edges * n,
+                [&] { allPairsShortestPaths(csr, matrix.data(), APSP_FLOYD_WARSHALL); });
+        measure(results, config, name, "csr", "apsp_dijkstra", n, edges * n,
+                [&] { allPairsShortestPaths(csr, matrix.data(), APSP_DIJKSTRA); });
+    }
+
+    // Layout comparison
+    UnweightedGraph unweighted = builder.buildGraph<Unweighted>();
+    InterleavedGraph interleaved = builder.buildGraph<Interleaved>();
+    CompressedGraph compressed(csr);
+    benchLayout(results, config, name, "adjacency", g, source, edges);
+    benchLayout(results, config, name, "unweighted", unweighted, source, edges);
+    benchLayout(results, config, name, "interleaved", interleaved, source, edges);
+    benchLayout(results, config, name, "csr", csr, source, edges);
+    benchLayout(results, config, name, "compressed", compressed, source, edges);
+}
+
+// Producers push the values [0, items) split into equal ranges, every consumer pops its share.
+// produce(begin, end) and consume(count) (returns the sum of the popped values) wrap the queue.
+template <class Produce, class Consume>
+static void runPipeline(int pairs, int items, Produce produce, Consume consume) {
+    std::vector<std::thread> threads;
+    std::vector<long long> sums(pairs, 0);
+    int share = items / pairs;
+    for (int k = 0; k < pairs; k++) {
+        threads.emplace_back([&, k] { produce(k * share, (k + 1) * share); });
+        threads.emplace_back([&, k] { sums[k] = consume(share); });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    long long total = 0, expected = (long long)share * pairs * (share * pairs - 1LL) / 2;
+    for (long long sum : sums) {
+        total += sum;
+    }
+    if (total != expected) {
+        throw "Queue benchmark lost items!";
+    }
+}
+
+// Parse throughput of a SNAP text held in memory, at every power of two thread count
+static void benchParse(std::vector<Result>& results, const Config& config) {
+    GraphBuilder builder;
+    generateRMAT(builder, config.scale + 6, config.edgeFactor, config.seed, 100);
+    CSRGraph csr = builder.buildCSR(true, true);
+    std::string text = "# R-MAT edge list\n";
+    char line[48];
+    for (int u = 0; u < csr.getNumVertices(); u++) {
+        for (Edge e : csr.edges(u)) {
+            if (u < e.dst) {
+                int length = std::snprintf(line, sizeof(line), "%d\t%d\t%d\n", u, e.dst, e.w);
+                text.append(line, length);
+            }
+        }
+    }
+    int maxThreads = (int)std::thread::hardware_concurrency();
+    if (maxThreads < 1) maxThreads = 1;
+    for (int threads = 1;; threads *= 2) {
+        if (threads > maxThreads) threads = maxThreads;
+        char name[16];
+        std::snprintf(name, sizeof(name), "snap_t%d", threads);
+        measure(results, config, "parse", "text", name, csr.getNumVertices(), (long long)text.size(), [&] {
+            GraphBuilder parsed;
+            parseEdgeList(text.data(), (long long)text.size(), EdgeListFormat::SNAP, parsed, threads);
+        });
+        if (threads == maxThreads) break;
+    }
+}
+
+static void benchQueues(std::vector<Result>& results, const Config& config) {
+    const int CAPACITY = 1024;
+    const int BATCH = 32;
+    int pairCounts[3] = {1, 2, 4};
+    for (int pairs : pairCounts) {
+        int items = (1 << (config.scale + 10)) / pairs * pairs;
+        char name[16];
+        std::snprintf(name, sizeof(name), "p%dc%d", pairs, pairs);
+
+        measure(results, config, "queue", "mutex", name, 0, items, [&] {
+            Queue queue(CAPACITY);
+            std::mutex lock;
+            runPipeline(pairs, items, [&](int begin, int end) {
+                for (int x = begin; x < end; x++) {
+                    std::lock_guard<std::mutex> guard(lock);
+                    queue.enqueue(x);
+                }
+            }, [&](int count) {
+                long long sum = 0;
+                while (count > 0) {
+                    int x = -1;
+                    {
+                        std::lock_guard<std::mutex> guard(lock);
+                        if (!queue.isEmpty()) x = queue.dequeue();
+                    }
+                    if (x < 0) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    sum += x;
+                    count--;
+                }
+                return sum;
+            });
+        });
+
+        measure(results, config, "queue", "mpmc", name, 0, items, [&] {
+            MPMCQueue queue(CAPACITY);
+            runPipeline(pairs, items, [&](int begin, int end) {
+                for (int x = begin; x < end; x++) {
+                    while (!queue.tryEnqueue(x)) std::this_thread::yield();
+                }
+            }, [&](int count) {
+                long long sum = 0;
+                int x;
+                while (count > 0) {
+                    if (!queue.tryDequeue(x)) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    sum += x;
+                    count--;
+                }
+                return sum;
+            });
+        });
+
+        measure(results, config, "queue", "mpmc_batch", name, 0, items, [&] {
+            MPMCQueue queue(CAPACITY);
+            runPipeline(pairs, items, [&](int begin, int end) {
+                int buffer[BATCH];
+                for (int x = begin; x < end;) {
+                    int count = end - x < BATCH ? end - x : BATCH;
+                    for (int i = 0; i < count; i++) buffer[i] = x + i;
+                    int sent = 0;
+                    while (sent < count) {
+                        int moved = queue.enqueueBatch(buffer + sent, count - sent);
+                        if (moved == 0) std::this_thread::yield();
+                        sent += moved;
+                    }
+                    x += count;
+                }
+            }, [&](int count) {
+                long long sum = 0;
+                int buffer[BATCH];
+                while (count > 0) {
+                    int got = queue.dequeueBatch(buffer, count < BATCH ? count : BATCH);
+                    if (got == 0) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    for (int i = 0; i < got; i++) sum += buffer[i];
+                    count -= got;
+                }
+                return sum;
+            });
+        });
+    }
+}
+
+static bool writeJson(const Config& config, const std::vector<Result>& results) {
+    FILE* f = std::fopen(config.out.c_str(), "w");
+    if (f == nullptr) {
+        return false;
+    }
+    std::fprintf(f, "{\n  \"config\": {\"scale\": %d, \"edge_factor\": %d, \"reps\": %d, \"seed\": %llu},\n",
+                 config.scale, config.edgeFactor, config.reps, config.seed);
+    std::fprintf(f, "  \"peak_rss_kb\": %ld,\n  \"results\": [\n", peakRssKb());
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        std::fprintf(f, "    {\"graph\": \"%s\", \"layout\": \"%s\", \"algorithm\": \"%s\", \"vertices\": %d, "
+                        "\"edges\": %lld, \"median_ms\": %.6f, \"p95_ms\": %.6f, \"teps\": %.1f, \"peak_rss_kb\": %ld",
+                     r.graph.c_str(), r.layout.c_str(), r.algorithm.c_str(), r.vertices, r.edges,
+                     r.medianMs, r.p95Ms, r.teps, r.peakRssKb);
+        if (config.perf) {
+            std::fprintf(f, ", \"perf\": {");
+            writeRatio(f, "cycles_per_edge", r.counts.cycles, r.edges, false);
+            writeRatio(f, "instructions_per_edge", r.counts.instructions, r.edges, false);
+            writeRatio(f, "llc_misses_per_edge", r.counts.llcMisses, r.edges, false);
+            writeRatio(f, "dtlb_misses_per_edge", r.counts.dtlbMisses, r.edges, false);
+            writeRatio(f, "cycles_per_vertex", r.counts.cycles, r.vertices, false);
+            writeRatio(f, "llc_misses_per_vertex", r.counts.llcMisses, r.vertices, true);
+            std::fprintf(f, "}");
+        }
+        std::fprintf(f, "}%s\n", i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(f, "  ]\n}\n");
+    std::fclose(f);
+    return true;
+}
+
+static void usage() {
+    std::printf("Usage: ./bench.exe [--scale S] [--edge-factor K] [--reps R] [--seed X]\n"
+                "                   [--graphs rmat,er,grid,ba,rgg] [--out bench.json] [--perf] [--queues] [--parse]\n");
+}
+
+int main(int argc, char** argv) {
+    Config config;
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--scale") == 0 && hasValue) {
+            config.scale = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--edge-factor") == 0 && hasValue) {
+            config.edgeFactor = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--reps") == 0 && hasValue) {
+            config.reps = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) {
+            config.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--graphs") == 0 && hasValue) {
+            config.graphs = argv[++i];
+        } else if (std::strcmp(argv[i], "--out") == 0 && hasValue) {
+            config.out = argv[++i];
+        } else if (std::strcmp(argv[i], "--perf") == 0) {
+            config.perf = true;
+        } else if (std::strcmp(argv[i], "--queues") == 0) {
+            config.queues = true;
+        } else if (std::strcmp(argv[i], "--parse") == 0) {
+            config.parse = true;
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (config.scale < 1 || config.scale > 30 || config.edgeFactor < 1 || config.reps < 1) {
+        usage();
+        return 1;
+    }
+
+    if (config.perf) {
+        counters = new PerfCounters();
+        if (!counters->available()) {
+            std::printf("Warning: hardware counters are not available (perf_event_paranoid or no PMU)\n");
+        }
+    }
+
+    std::vector<Result> results;
+    try {
+        size_t start = 0;
+        while (start <= config.graphs.size()) { // Comma separated generator names
+            size_t end = config.graphs.find(',', start);
+            if (end == std::string::npos) end = config.graphs.size();
+            if (end > start) benchGraph(results, config, config.graphs.substr(start, end - start));
+            start = end + 1;
+        }
+        if (config.queues) {
+            benchQueues(results, config);
+        }
+        if (config.parse) {
+            benchParse(results, config);
+        }
+    } catch (const char* e) {
+        std::printf("Error: %s\n", e);
+        delete counters;
+        return 1;
+    }
+    delete counters;
+
+    if (!writeJson(config, results)) {
+        std::printf("Error: cannot write %s\n", config.out.c_str());
+        return 1;
+    }
+    std::printf("Wrote %zu results to %s\n", results.size(), config.out.c_str());
+    return 0;
+}
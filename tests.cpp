@@ -6,9 +6,34 @@
 
 #include "Graph.h"
 #include "Algorithms.h"
+#include "CSRGraph.h"
+#include "GraphBuilder.h"
+#include "GraphIO.h"
+#include "CompressedGraph.h"
+#include "Generators.h"
+#include "PerfCounters.h"
+#include "QueryEngine.h"
+#include "ThreadPool.h"
+#include "DataStructures.h"
+#include "APSP.h"
+#include "DynamicSSSP.h"
+#include "DynamicMST.h"
+#include "DynamicConnectivity.h"
+#include "OfflineConnectivity.h"
+#include "PageRank.h"
+#include "Triangles.h"
+#include "KCore.h"
 #include <vector>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
 #include <numeric> // For std::accumulate (though not used directly here)
 #include <iostream> // For potential debug printing in tests
+#include <utility> // For std::move
+#include <cstdio> // For temporary graph files
+#include <string>
+#include <thread>
+#include <atomic>
 
 // Use the project's namespace
 using namespace graph;
@@ -148,6 +173,1760 @@ TEST_CASE("Graph Class Tests") {
         g_orig.addEdge(0, 2, 1);
         CHECK(edgeExists(g_assigned, 0, 2, 1) == false);
     }
+
+    SUBCASE("Copy-On-Write Sharing") {
+        Graph base(200); // Spans several chunks
+        for (int v = 1; v < 200; v++) {
+            base.addEdge(0, v, v);
+        }
+        Graph snap = base;
+        CHECK(snap.getAdjList(5) == base.getAdjList(5)); // Lists are shared after copy
+
+        snap.addEdge(5, 6, 3);
+        CHECK(snap.getAdjList(5) != base.getAdjList(5)); // Mutated vertex got its own list
+        CHECK(snap.getAdjList(7) == base.getAdjList(7)); // Same chunk, untouched vertex still shared
+        CHECK(snap.getAdjList(150) == base.getAdjList(150));
+        CHECK(edgeExists(snap, 5, 6, 3) == true);
+        CHECK(edgeExists(base, 5, 6, 3) == false);
+
+        base.removeEdge(0, 150);
+        CHECK(edgeExists(snap, 0, 150, 150) == true);
+        CHECK(edgeExists(base, 0, 150, 150) == false);
+        CHECK(snap.getSize(0) == 199);
+        CHECK(base.getSize(0) == 198);
+    }
+
+    SUBCASE("Arena Storage") {
+        Graph g(100);
+        for (int v = 1; v < 100; v++) {
+            g.addEdge(0, v, v);
+        }
+        long long reserved = g.bytesReserved();
+        CHECK(reserved > 0);
+        // Removing and re-adding edges reuses freed blocks instead of growing the arena
+        for (int round = 0; round < 10; round++) {
+            for (int v = 1; v < 100; v++) {
+                g.removeEdge(0, v);
+            }
+            for (int v = 1; v < 100; v++) {
+                g.addEdge(0, v, v + round);
+            }
+        }
+        CHECK(g.bytesReserved() == reserved);
+        CHECK(g.getSize(0) == 99);
+        CHECK(edgeExists(g, 0, 42, 51) == true);
+        // Removal keeps the order of the remaining neighbors
+        g.removeEdge(0, 2);
+        CHECK(g.getAdjList(0)[0] == 1);
+        CHECK(g.getAdjList(0)[1] == 3);
+        CHECK(g.getWeights(0)[1] == 12);
+    }
+
+    SUBCASE("Move") {
+        Graph g_orig(3);
+        g_orig.addEdge(0, 1, 10);
+        const int* list_before = g_orig.getAdjList(0);
+
+        // Move constructor takes the lists without copying
+        Graph g_moved(std::move(g_orig));
+        CHECK(g_moved.getAdjList(0) == list_before);
+        CHECK(edgeExists(g_moved, 0, 1, 10) == true);
+        CHECK(g_orig.getNumVertices() == 0); // Moved-from graph is empty but usable
+
+        // Move assignment
+        Graph g_target(5);
+        g_target.addEdge(3, 4, 2);
+        g_target = std::move(g_moved);
+        CHECK(g_target.getNumVertices() == 3);
+        CHECK(g_target.getAdjList(0) == list_before);
+        CHECK(edgeExists(g_target, 0, 1, 10) == true);
+
+        // Moved-from graphs can be assigned again
+        g_orig = g_target;
+        CHECK(edgeExists(g_orig, 0, 1, 10) == true);
+    }
+}
+
+
+TEST_CASE("Unweighted Graph Tests") {
+    UnweightedGraph g(4);
+    g.addEdge(0, 1);
+    g.addEdge(1, 2, 7); // Weight argument is ignored
+    g.addEdge(2, 3);
+    CHECK(g.getSize(1) == 2);
+    CHECK(g.getWeights(1) == nullptr); // No weights array is stored
+    CHECK(g.weightAt(1, 1) == 1);     // Implicit weight
+
+    UnweightedGraph g_copy = g;
+    g_copy.removeEdge(1, 2);
+    CHECK(g.getSize(1) == 2);
+    CHECK(g_copy.getSize(1) == 1);
+
+    BasicAlgorithms<UnweightedGraph> alg(g);
+    Graph bfs_tree = alg.bfs(0);
+    CHECK(edgeExists(bfs_tree, 0, 1, 1) == true);
+    CHECK(edgeExists(bfs_tree, 1, 2, 1) == true);
+    CHECK(edgeExists(bfs_tree, 2, 3, 1) == true);
+    CHECK(getTotalWeight(alg.kruskal()) == 3);
+}
+
+
+TEST_CASE("Interleaved Graph Tests") {
+    InterleavedGraph g(5);
+    Graph g_plain(5);
+    int edges[7][3] = {{0, 1, 1}, {0, 2, 4}, {1, 2, 2}, {1, 3, 5}, {2, 3, 1}, {2, 4, 3}, {3, 4, 2}};
+    for (int i = 0; i < 7; i++) {
+        g.addEdge(edges[i][0], edges[i][1], edges[i][2]);
+        g_plain.addEdge(edges[i][0], edges[i][1], edges[i][2]);
+    }
+    CHECK(g.getAdjList(1) == nullptr); // No separate arrays in this layout
+    CHECK(g.getWeights(1) == nullptr);
+
+    // Both layouts expose the same edges in the same order
+    for (int u = 0; u < 5; u++) {
+        CHECK(g.getSize(u) == g_plain.getSize(u));
+        int i = 0;
+        for (Edge e : g.edges(u)) {
+            CHECK(e.dst == g_plain.neighborAt(u, i));
+            CHECK(e.w == g_plain.weightAt(u, i));
+            i++;
+        }
+        CHECK(i == g.getSize(u));
+    }
+
+    g.removeEdge(1, 2);
+    CHECK(g.getSize(1) == 2);
+    CHECK(g.neighborAt(1, 1) == 3);
+    CHECK(g.weightAt(1, 1) == 5);
+    g.addEdge(1, 2, 2);
+
+    BasicAlgorithms<InterleavedGraph> alg(g);
+    CHECK(getTotalWeight(alg.prim()) == 6);
+    CHECK(getTotalWeight(alg.kruskal()) == 6);
+    CHECK(edgeExists(alg.dijkstra(0), 2, 3, 1) == true);
+}
+
+
+TEST_CASE("CSR Graph and Binary File Tests") {
+    Graph g(5);
+    g.addEdge(0, 1, 1);
+    g.addEdge(0, 2, 4);
+    g.addEdge(1, 2, 2);
+    g.addEdge(1, 3, 5);
+    g.addEdge(2, 3, 1);
+    g.addEdge(2, 4, 3);
+    g.addEdge(3, 4, 2);
+
+    CSRGraph csr = CSRGraph::fromGraph(g);
+    CHECK(csr.getNumVertices() == 5);
+    CHECK(csr.getNumEdges() == 14); // Each undirected edge is stored in both directions
+    CHECK(csr.isWeighted() == true);
+    CHECK(csr.isSymmetric() == true);
+    for (int u = 0; u < 5; u++) {
+        CHECK(csr.getSize(u) == g.getSize(u));
+        for (int i = 0; i < g.getSize(u); i++) {
+            CHECK(csr.neighborAt(u, i) == g.neighborAt(u, i));
+            CHECK(csr.weightAt(u, i) == g.weightAt(u, i));
+        }
+    }
+
+    const char* path = "test_graph.bin";
+    csr.writeFile(path);
+    {
+        CSRGraph mapped = CSRGraph::mapFile(path);
+        CHECK(mapped.isMapped() == true);
+        CHECK(mapped.getNumEdges() == 14);
+        CHECK(mapped.getOffsets()[5] == 14);
+        CHECK(mapped.weightAt(3, 2) == 2); // Edge 3-4
+
+        BasicAlgorithms<CSRGraph> alg(mapped);
+        Graph sp_tree = alg.dijkstra(0);
+        CHECK(edgeExists(sp_tree, 1, 2, 2) == true);
+        CHECK(edgeExists(sp_tree, 2, 4, 3) == true);
+        CHECK(getTotalWeight(alg.kruskal()) == 6);
+
+        CSRGraph moved = std::move(mapped);
+        CHECK(moved.isMapped() == true);
+        CHECK(mapped.getNumVertices() == 0);
+    }
+
+    // Unweighted graphs have no weights section
+    UnweightedGraph ug(3);
+    ug.addEdge(0, 1);
+    CSRGraph::fromGraph(ug).writeFile(path);
+    CSRGraph mapped_u = CSRGraph::mapFile(path);
+    CHECK(mapped_u.isWeighted() == false);
+    CHECK(mapped_u.weightAt(0, 0) == 1);
+    CHECK(mapped_u.getSize(2) == 0);
+
+    // Header positions that wrap around 2^64 or point into the header itself
+    {
+        GraphBuilder ring(40);
+        for (int v = 0; v < 40; v++) ring.addEdge(v, (v + 1) % 40);
+        ring.buildCSR().writeFile(path);        // Every section is longer than 256 bytes
+        FILE* in = std::fopen(path, "rb");
+        std::vector<char> bytes;
+        for (int c = std::fgetc(in); c != EOF; c = std::fgetc(in)) bytes.push_back((char)c);
+        std::fclose(in);
+        auto mapPatched = [&](unsigned long long GraphFileHeader::*field, unsigned long long value) {
+            GraphFileHeader header;
+            std::memcpy(&header, bytes.data(), sizeof(header));
+            header.*field = value;
+            FILE* out = std::fopen(path, "wb");
+            std::fwrite(&header, sizeof(header), 1, out);
+            std::fwrite(bytes.data() + sizeof(header), 1, bytes.size() - sizeof(header), out);
+            std::fclose(out);
+            CSRGraph patched = CSRGraph::mapFile(path);
+        };
+        CHECK_NOTHROW(mapPatched(&GraphFileHeader::fileSize, bytes.size()));
+        CHECK_THROWS_AS(mapPatched(&GraphFileHeader::neighborsPos, 0ULL - GRAPH_FILE_ALIGN), const char*);
+        CHECK_THROWS_AS(mapPatched(&GraphFileHeader::weightsPos, 0ULL - 2 * GRAPH_FILE_ALIGN), const char*);
+        CHECK_THROWS_AS(mapPatched(&GraphFileHeader::offsetsPos, 0ULL - 4 * GRAPH_FILE_ALIGN), const char*);
+        CHECK_THROWS_AS(mapPatched(&GraphFileHeader::offsetsPos, 0ULL), const char*);
+    }
+
+    // Not a graph file
+    FILE* f = std::fopen(path, "wb");
+    std::fputs("this is not a graph file, just some text long enough for a header", f);
+    std::fclose(f);
+    CHECK_THROWS_AS(CSRGraph::mapFile(path), const char*);
+    std::remove(path);
+    CHECK_THROWS_AS(CSRGraph::mapFile(path), const char*);
+}
+
+
+TEST_CASE("Graph Builder and Edge List Parser Tests") {
+    SUBCASE("Bulk Builder") {
+        GraphBuilder b;
+        b.addEdge(2, 0, 4);
+        b.addEdge(0, 1, 1);
+        b.addEdge(1, 0, 3); // Parallel edge, the smaller weight is kept
+        b.addEdge(2, 2, 9); // Self-loop, dropped
+        b.addEdge(1, 2, 2);
+        CHECK(b.getNumVertices() == 3);
+
+        CSRGraph csr = b.buildCSR();
+        CHECK(csr.getNumEdges() == 6);
+        CHECK(csr.getSize(0) == 2);
+        CHECK(csr.neighborAt(0, 0) == 1); // Neighbor lists are sorted
+        CHECK(csr.neighborAt(0, 1) == 2);
+        CHECK(csr.weightAt(0, 0) == 1);
+        CHECK(csr.weightAt(0, 1) == 4);
+
+        CSRGraph directed = b.buildCSR(false);
+        CHECK(directed.isSymmetric() == false);
+        CHECK(directed.getNumEdges() == 4); // 2->0, 0->1, 1->0, 1->2
+        CHECK(directed.getSize(1) == 2);    // 1->0 and 1->2
+
+        Graph g = b.buildGraph<Weighted>();
+        CHECK(edgeExists(g, 0, 1, 1) == true);
+        CHECK(edgeExists(g, 0, 2, 4) == true);
+        CHECK(edgeExists(g, 1, 2, 2) == true);
+        g.addEdge(0, 1, 5); // Bulk-loaded graphs stay mutable
+        g.removeEdge(1, 2);
+        CHECK(g.getSize(1) == 1);
+        CHECK_THROWS_AS(b.addEdge(-1, 0), const char*);
+    }
+
+    SUBCASE("SNAP") {
+        std::string text = "# Directed graph\n# FromNodeId\tToNodeId\n0\t1\n1\t2\n\n  2 3\r\n";
+        GraphBuilder b;
+        EdgeListInfo info = parseEdgeList(text.c_str(), (long long)text.size(), EdgeListFormat::SNAP, b);
+        CHECK(info.numEdges == 3);
+        CHECK(info.numVertices == 4);
+        CHECK(info.weighted == false);
+        Graph g = b.buildGraph<Weighted>();
+        CHECK(edgeExists(g, 2, 3, 1) == true);
+
+        std::string bad = "0 1\n1 x\n";
+        GraphBuilder b2;
+        CHECK_THROWS_AS(parseEdgeList(bad.c_str(), (long long)bad.size(), EdgeListFormat::SNAP, b2), const char*);
+    }
+
+    SUBCASE("DIMACS") {
+        std::string text = "c 9th DIMACS challenge\np sp 4 3\na 1 2 7\na 2 3 123456789\nc comment\na 4 1 2\n";
+        GraphBuilder b;
+        EdgeListInfo info = parseEdgeList(text.c_str(), (long long)text.size(), EdgeListFormat::DIMACS, b);
+        CHECK(info.numVertices == 4);
+        CHECK(info.numEdges == 3);
+        CHECK(info.weighted == true);
+        CSRGraph arcs = b.buildCSR(false);
+        CHECK(arcs.getSize(1) == 1);
+        CHECK(arcs.neighborAt(1, 0) == 2);
+        CHECK(arcs.weightAt(1, 0) == 123456789);
+        CHECK(arcs.neighborAt(3, 0) == 0);
+    }
+
+    SUBCASE("Matrix Market") {
+        std::string text = "%%MatrixMarket matrix coordinate real symmetric\n% comment\n5 5 3\n2 1 1.5\n3 2 -2.0e1\n5 4 3\n";
+        GraphBuilder b;
+        EdgeListInfo info = parseEdgeList(text.c_str(), (long long)text.size(), EdgeListFormat::MatrixMarket, b);
+        CHECK(info.numVertices == 5);
+        CHECK(info.symmetric == true);
+        CHECK(info.weighted == true);
+        CSRGraph csr = b.buildCSR(info.symmetric);
+        CHECK(csr.weightAt(0, 0) == 2);   // 1.5 rounded
+        CHECK(csr.weightAt(2, 0) == -20);
+        CHECK(csr.getSize(4) == 1);
+
+        std::string pattern = "%%MatrixMarket matrix coordinate pattern general\n3 3 2\n1 2\n2 3\n";
+        GraphBuilder b2;
+        info = parseEdgeList(pattern.c_str(), (long long)pattern.size(), EdgeListFormat::MatrixMarket, b2);
+        CHECK(info.weighted == false);
+        CHECK(info.symmetric == false);
+        CHECK(b2.getNumEdges() == 2);
+
+        std::string array = "%%MatrixMarket matrix array real general\n2 2\n1\n2\n3\n4\n";
+        CHECK_THROWS_AS(parseEdgeList(array.c_str(), (long long)array.size(), EdgeListFormat::MatrixMarket, b2), const char*);
+    }
+
+    SUBCASE("Parallel Parsing Matches Serial") {
+        std::string text;
+        for (int i = 0; i < 200000; i++) { // ~2.5 MB so several chunks are used
+            text += std::to_string(i % 5000) + " " + std::to_string((i * 7919) % 100003 + 12345678) + " " + std::to_string(i % 97) + "\n";
+        }
+        GraphBuilder serial, parallel;
+        parseEdgeList(text.c_str(), (long long)text.size(), EdgeListFormat::SNAP, serial, 1);
+        parseEdgeList(text.c_str(), (long long)text.size(), EdgeListFormat::SNAP, parallel, 8);
+        CHECK(serial.getNumEdges() == 200000);
+        CHECK(parallel.getNumEdges() == 200000);
+        CHECK(parallel.getNumVertices() == serial.getNumVertices());
+        CSRGraph a = serial.buildCSR(false);
+        CSRGraph c = parallel.buildCSR(false);
+        bool same = a.getNumEdges() == c.getNumEdges();
+        for (long long i = 0; same && i < a.getNumEdges(); i++) {
+            same = a.getNeighbors()[i] == c.getNeighbors()[i] && a.getWeights()[i] == c.getWeights()[i];
+        }
+        CHECK(same == true);
+    }
+}
+
+
+TEST_CASE("Compressed Graph Tests") {
+    // Two components: a weighted path 0-1-2-3 with a far neighbor, and 4-5
+    Graph g(2000);
+    g.addEdge(2, 1, 5);
+    g.addEdge(0, 1, -3);
+    g.addEdge(2, 3, 100000);
+    g.addEdge(0, 1999, 7);
+    g.addEdge(4, 5, 1);
+    CSRGraph csr = CSRGraph::fromGraph(g); // Unsorted lists (insertion order)
+    CompressedGraph cg(csr);
+    CHECK(cg.getNumVertices() == 2000);
+    CHECK(cg.getNumEdges() == 10);
+    CHECK(cg.getSize(1) == 2);
+    CHECK(cg.bytesUsed() > 0);
+
+    // Neighbors come back sorted with their weights
+    int expected_dst[2] = {0, 2};
+    int expected_w[2] = {-3, 5};
+    int i = 0;
+    for (Edge e : cg.edges(1)) {
+        CHECK(e.dst == expected_dst[i]);
+        CHECK(e.w == expected_w[i]);
+        i++;
+    }
+    CHECK(i == 2);
+    i = 0;
+    for (Edge e : cg.edges(1999)) { // First gap is negative (zigzag)
+        CHECK(e.dst == 0);
+        CHECK(e.w == 7);
+        i++;
+    }
+    CHECK(i == 1);
+    for (Edge e : cg.edges(10)) { // Isolated vertex
+        (void)e;
+        CHECK(false);
+    }
+
+    BasicAlgorithms<CompressedGraph> alg(cg);
+    std::vector<int> component(2000);
+    CHECK(alg.connectedComponents(component.data()) == 1995); // {0,1,2,3,1999}, {4,5} and 1993 isolated vertices
+    CHECK(component[0] == component[3]);
+    CHECK(component[0] == component[1999]);
+    CHECK(component[4] == component[5]);
+    CHECK(component[0] != component[4]);
+    Graph bfs_tree = alg.bfs(0);
+    CHECK(edgeExists(bfs_tree, 2, 3, 100000) == true);
+
+    Algorithms alg_plain(g);
+    std::vector<int> component_plain(2000);
+    CHECK(alg_plain.connectedComponents(component_plain.data()) == 1995);
+}
+
+
+TEST_CASE("Graph Generator Tests") {
+    SUBCASE("Same Seed Gives Same Graph For Any Thread Count") {
+        GraphBuilder one_thread, four_threads;
+        generateRMAT(one_thread, 12, 4, 42, 10, 0.57, 0.19, 0.19, 1);
+        generateRMAT(four_threads, 12, 4, 42, 10, 0.57, 0.19, 0.19, 4);
+        CSRGraph a = one_thread.buildCSR();
+        CSRGraph b = four_threads.buildCSR();
+        CHECK(a.getNumVertices() == 4096);
+        CHECK(a.getNumEdges() == b.getNumEdges());
+        bool same = true;
+        for (long long i = 0; i < a.getNumEdges(); i++) {
+            if (a.getNeighbors()[i] != b.getNeighbors()[i] || a.getWeights()[i] != b.getWeights()[i]) same = false;
+        }
+        CHECK(same == true);
+
+        GraphBuilder other_seed;
+        generateRMAT(other_seed, 12, 4, 43, 10);
+        CHECK(other_seed.buildCSR().getNumEdges() != a.getNumEdges());
+    }
+
+    SUBCASE("Erdos-Renyi") {
+        GraphBuilder builder;
+        generateErdosRenyi(builder, 1000, 5000, 7, 100, 3);
+        CHECK(builder.getNumEdges() == 5000);
+        CSRGraph csr = builder.buildCSR();
+        CHECK(csr.getNumEdges() > 9000); // Few duplicates and self-loops among 5000 random pairs
+        CHECK(csr.getNumEdges() <= 10000);
+        bool weights_in_range = true;
+        for (long long i = 0; i < csr.getNumEdges(); i++) {
+            if (csr.getWeights()[i] < 1 || csr.getWeights()[i] > 100) weights_in_range = false;
+        }
+        CHECK(weights_in_range == true);
+    }
+
+    SUBCASE("Grid") {
+        GraphBuilder builder;
+        generateGrid(builder, 3, 4, 1);
+        Graph g = builder.buildGraph<Weighted>();
+        CHECK(g.getNumVertices() == 12);
+        CHECK(g.getSize(0) == 2);  // Corner
+        CHECK(g.getSize(5) == 4);  // Inner vertex
+        CHECK(edgeExists(g, 5, 9, 1) == true);
+        CHECK(edgeExists(g, 3, 4, 1) == false); // End of a row
+        CHECK(getTotalWeight(g) == 17);
+    }
+
+    SUBCASE("Barabasi-Albert") {
+        GraphBuilder builder;
+        generateBarabasiAlbert(builder, 5000, 3, 11, 1, 2);
+        CSRGraph csr = builder.buildCSR();
+        int max_degree = 0;
+        for (int v = 0; v < csr.getNumVertices(); v++) {
+            if (csr.getSize(v) > max_degree) max_degree = csr.getSize(v);
+        }
+        CHECK(max_degree > 50); // Preferential attachment creates hubs
+        Graph g = builder.buildGraph<Weighted>();
+        Algorithms alg(g);
+        std::vector<int> component(5000);
+        CHECK(alg.connectedComponents(component.data()) == 1); // Every vertex attaches to an earlier one
+    }
+
+    SUBCASE("Random Geometric") {
+        GraphBuilder builder;
+        generateRandomGeometric(builder, 2000, 0.05, 5, 3);
+        CSRGraph csr = builder.buildCSR();
+        CHECK(csr.getNumEdges() > 0);
+        bool short_edges = true;
+        for (long long i = 0; i < csr.getNumEdges(); i++) {
+            if (csr.getWeights()[i] > 50) short_edges = false; // Distance * 1000 < radius * 1000
+        }
+        CHECK(short_edges == true);
+
+        GraphBuilder serial;
+        generateRandomGeometric(serial, 2000, 0.05, 5, 1);
+        CHECK(serial.buildCSR().getNumEdges() == csr.getNumEdges());
+
+        GraphBuilder tiny;                  // 1 / radius far beyond INT_MAX: no edges, no overflow
+        generateRandomGeometric(tiny, 100, 1e-12, 5);
+        CHECK(tiny.getNumEdges() == 0);
+        CHECK_THROWS_AS(generateRandomGeometric(tiny, 100, std::nan(""), 5), const char*);
+        CHECK_THROWS_AS(generateRandomGeometric(tiny, 100, 0.0, 5), const char*);
+    }
+
+    GraphBuilder invalid;
+    CHECK_THROWS_AS(generateGrid(invalid, 0, 5, 1), const char*);
+    CHECK_THROWS_AS(generateRMAT(invalid, 10, 4, 1, 1, 0.6, 0.3, 0.3), const char*);
+}
+
+
+TEST_CASE("Perf Counter Instrumentation Tests") {
+    Graph g(4);
+    g.addEdge(0, 1, 1);
+    g.addEdge(1, 2, 1);
+    g.addEdge(2, 3, 1);
+    Algorithms alg(g);
+
+    setPerfCounters(true);
+    CHECK(perfCountersEnabled() == true);
+    alg.bfs(0);
+    PerfSample sample = lastPerfSample();
+    CHECK(std::string(sample.name) == "bfs");
+    CHECK(sample.vertices == 4);
+    CHECK(sample.edges == 6);               // Adjacency entries
+    CHECK(sample.counts.cycles >= -1);      // -1 when the machine has no counters
+    CHECK(sample.counts.dtlbMisses >= -1);
+
+    {
+        PerfScope outer("outer", 1, 1);
+        alg.dfs(0);                         // Nested inside outer, not recorded
+        CHECK(std::string(lastPerfSample().name) == "bfs");
+    }
+    CHECK(std::string(lastPerfSample().name) == "outer");
+
+    setPerfCounters(false);
+    alg.dijkstra(0);                        // Switched off, nothing recorded
+    CHECK(std::string(lastPerfSample().name) == "outer");
+
+    PerfCounters counters;
+    counters.start();
+    PerfCounts counts = counters.stop();
+    CHECK((counters.available() || counts.cycles == -1) == true);
+}
+
+
+TEST_CASE("Algorithm Stats Tests") {
+    Graph g(4);
+    g.addEdge(0, 1, 1);
+    g.addEdge(0, 2, 4);
+    g.addEdge(1, 2, 2);
+    g.addEdge(2, 3, 1);
+    Algorithms alg(g);
+    AlgorithmStats stats;
+    stats.heapPushes = 123;             // Overwritten by every call
+
+    alg.dijkstra(0, &stats);
+    if (algorithmStatsEnabled()) {      // make STATS=1
+        CHECK(stats.verticesVisited == 4);
+        CHECK(stats.heapPushes == 5);
+        CHECK(stats.heapPops == 5);
+        CHECK(stats.stalePops == 1);    // Vertex 2 was pushed with 4 and then 3
+        CHECK(stats.relaxations == 4);
+        CHECK(stats.edgesScanned == 14); // 8 relaxation scans + 6 parent lookups
+    } else {
+        CHECK(stats.heapPushes == 0);
+        CHECK(stats.edgesScanned == 0);
+    }
+
+    alg.bfs(0, &stats);
+    CHECK(stats.edgesScanned == (algorithmStatsEnabled() ? 8 : 0));
+    CHECK(stats.heapPushes == 0);
+
+    alg.kruskal(&stats);
+    if (algorithmStatsEnabled()) {
+        CHECK(stats.unions == 3);
+        CHECK(stats.finds == 12);
+        CHECK(stats.maxFindPath == 1);
+        CHECK(stats.findPathLength == 2);
+    }
+
+    std::vector<int> component(4);
+    CHECK(alg.connectedComponents(component.data(), &stats) == 1);
+    CHECK(stats.verticesVisited == (algorithmStatsEnabled() ? 4 : 0));
+    CHECK(alg.prim().getNumVertices() == 4); // Stats are optional
+}
+
+
+TEST_CASE("MPMC Queue Tests") {
+    SUBCASE("Single Thread") {
+        CHECK_THROWS_AS(MPMCQueue(0), const char*);
+        MPMCQueue queue(5);
+        CHECK(queue.capacity() == 8);               // Rounded up to a power of two
+        int x = 0;
+        CHECK(queue.tryDequeue(x) == false);
+        for (int i = 0; i < 8; i++) {
+            CHECK(queue.tryEnqueue(i) == true);
+        }
+        CHECK(queue.tryEnqueue(8) == false);        // Full
+        CHECK(queue.sizeEstimate() == 8);
+        CHECK(queue.tryDequeue(x) == true);
+        CHECK(x == 0);                              // FIFO
+
+        int batch[8] = {10, 11, 12};
+        CHECK(queue.enqueueBatch(batch, 3) == 1);   // Only one free cell
+        CHECK(queue.dequeueBatch(batch, 8) == 8);
+        CHECK(batch[0] == 1);
+        CHECK(batch[7] == 10);
+        CHECK(queue.dequeueBatch(batch, 8) == 0);
+        for (int lap = 0; lap < 3; lap++) {         // Wrap around several times
+            int values[5] = {lap, lap + 1, lap + 2, lap + 3, lap + 4};
+            CHECK(queue.enqueueBatch(values, 5) == 5);
+            CHECK(queue.dequeueBatch(batch, 3) == 3);
+            CHECK(batch[2] == lap + 2);
+            CHECK(queue.dequeueBatch(batch, 3) == 2);
+            CHECK(batch[1] == lap + 4);
+        }
+    }
+
+    SUBCASE("Producers And Consumers") {
+        const int PAIRS = 4;
+        const int PER_THREAD = 20000;
+        MPMCQueue queue(64);
+        std::atomic<int>* seen = new std::atomic<int>[PAIRS * PER_THREAD];
+        for (int i = 0; i < PAIRS * PER_THREAD; i++) seen[i].store(0);
+        std::vector<std::thread> threads;
+        for (int k = 0; k < PAIRS; k++) {
+            threads.emplace_back([&, k] {   // Producer: alternate single and batch pushes
+                int batch[7];
+                int x = k * PER_THREAD, end = x + PER_THREAD;
+                while (x < end) {
+                    if (x % 2 == 0) {
+                        if (queue.tryEnqueue(x)) x++;
+                    } else {
+                        int count = end - x < 7 ? end - x : 7;
+                        for (int i = 0; i < count; i++) batch[i] = x + i;
+                        x += queue.enqueueBatch(batch, count);
+                    }
+                }
+            });
+            threads.emplace_back([&, k] {   // Consumer: takes exactly PER_THREAD items
+                int batch[5];
+                int remaining = PER_THREAD;
+                while (remaining > 0) {
+                    int got = k % 2 == 0 ? queue.dequeueBatch(batch, remaining < 5 ? remaining : 5)
+                                         : (queue.tryDequeue(batch[0]) ? 1 : 0);
+                    for (int i = 0; i < got; i++) seen[batch[i]].fetch_add(1);
+                    remaining -= got;
+                }
+            });
+        }
+        for (std::thread& t : threads) t.join();
+        int once = 0;
+        for (int i = 0; i < PAIRS * PER_THREAD; i++) {
+            if (seen[i].load() == 1) once++;
+        }
+        CHECK(once == PAIRS * PER_THREAD);          // Every item delivered exactly once
+        CHECK(queue.sizeEstimate() == 0);
+        delete[] seen;
+    }
+}
+
+
+TEST_CASE("Query Engine Tests") {
+    SUBCASE("Indexed Heap") {
+        IndexedHeap heap(10);
+        heap.pushOrDecrease(5, 50);
+        heap.pushOrDecrease(3, 30);
+        heap.pushOrDecrease(8, 80);
+        CHECK(heap.pushOrDecrease(8, 10) == true);  // Decrease key
+        CHECK(heap.pushOrDecrease(3, 40) == false); // Not smaller
+        CHECK(heap.contains(5) == true);
+        CHECK(heap.popMin().vertex == 8);
+        CHECK(heap.popMin().vertex == 3);
+        CHECK(heap.popMin().priority == 50);
+        CHECK(heap.isEmpty() == true);
+        CHECK(heap.contains(5) == false);
+        heap.pushOrDecrease(1, 1);
+        heap.clear();
+        CHECK(heap.isEmpty() == true);
+        CHECK_THROWS_AS(heap.popMin(), const char*);
+    }
+
+    SUBCASE("Queries") {
+        Graph g(4);
+        g.addEdge(0, 1, 2);
+        g.addEdge(1, 2, 3);
+        g.addEdge(0, 2, 10);
+        const Graph& read_only = g;
+        Algorithms alg(read_only);                  // Algorithms only needs a const graph
+        CHECK(alg.bfs(0).getSize(0) == 2);
+
+        QueryEngine engine(CSRGraph::fromGraph(read_only), 2);
+        CHECK(engine.getNumWorkspaces() == 2);
+        BasicAlgorithms<CSRGraph> csr_alg(engine.getGraph());
+        CHECK(csr_alg.dfs(0).getNumVertices() == 4);
+
+        int dist[4], parent[4];
+        CHECK(engine.bfs(0, dist) == 3);
+        CHECK(dist[1] == 1);
+        CHECK(dist[2] == 1);
+        CHECK(dist[3] == -1);
+        CHECK(engine.dijkstra(0, dist, parent) == 3);
+        CHECK(dist[2] == 5);
+        CHECK(parent[2] == 1);
+        CHECK(parent[0] == -1);
+        CHECK(dist[3] == DIST_INF);
+        CHECK(engine.distance(0, 2) == 5);
+        CHECK(engine.distance(2, 0) == 5);
+        CHECK(engine.distance(0, 3) == DIST_INF);
+        CHECK_THROWS_AS(engine.distance(0, 4), const char*);
+
+        Graph negative(2);                          // Undirected: 0 -> 1 -> 0 is a negative cycle
+        negative.addEdge(0, 1, -1);
+        CHECK_THROWS_AS(QueryEngine(CSRGraph::fromGraph(negative), 1), const char*);
+    }
+
+    SUBCASE("Concurrent Queries") {
+        GraphBuilder builder;
+        generateGrid(builder, 40, 40, 3, 20);
+        QueryEngine engine(builder.buildCSR(), 2);  // Fewer workspaces than threads
+        int n = engine.getGraph().getNumVertices();
+        const int sources = 16;
+        std::vector<int> expected((size_t)sources * n);
+        for (int s = 0; s < sources; s++) {
+            engine.dijkstra(s * 97 % n, expected.data() + (size_t)s * n);
+        }
+
+        const int threads = 4;
+        std::vector<int> mismatches(threads, 0);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.push_back(std::thread([&, t] {
+                std::vector<int> dist(n);
+                for (int round = 0; round < 20; round++) {
+                    int s = (t * 5 + round) % sources;
+                    const int* want = expected.data() + (size_t)s * n;
+                    engine.dijkstra(s * 97 % n, dist.data());
+                    for (int v = 0; v < n; v++) {
+                        if (dist[v] != want[v]) mismatches[t]++;
+                    }
+                    int target = (round * 131 + t) % n;
+                    if (engine.distance(s * 97 % n, target) != want[target]) mismatches[t]++;
+                }
+            }));
+        }
+        for (std::thread& w : workers) {
+            w.join();
+        }
+        for (int t = 0; t < threads; t++) {
+            CHECK(mismatches[t] == 0);
+        }
+    }
+}
+
+
+TEST_CASE("Thread Pool Tests") {
+    setNumThreads(4);
+    CHECK(getNumThreads() == 4);
+    CHECK(defaultThreadPool().size() == 4);
+
+    SUBCASE("Every Index Exactly Once") {
+        const int n = 200000;
+        std::vector<int> visits(n, 0);
+        std::atomic<int> calls(0);
+        parallel_for(0, n, [&](long long begin, long long end) {
+            for (long long i = begin; i < end; i++) visits[i]++;
+            calls++;
+        });
+        bool once = true;
+        for (int i = 0; i < n; i++) {
+            if (visits[i] != 1) once = false;
+        }
+        CHECK(once == true);
+        CHECK(calls.load() > 1);    // Split into pieces
+    }
+
+    SUBCASE("Degree-Aware Splitting") {
+        const int n = 1000;
+        std::vector<long long> offsets(n + 1);
+        offsets[0] = 0;
+        for (int v = 0; v < n; v++) {
+            offsets[v + 1] = offsets[v] + (v == 500 ? 1000000 : 1); // Vertex 500 is a hub
+        }
+        std::vector<int> visits(n, 0);
+        std::atomic<int> hub_range_size(0);
+        parallel_for_weighted(0, n, offsets.data(), [&](long long begin, long long end) {
+            for (long long v = begin; v < end; v++) visits[v]++;
+            if (begin <= 500 && 500 < end) hub_range_size = (int)(end - begin);
+        });
+        CHECK(hub_range_size.load() == 1);  // The hub does not drag other vertices along
+        bool once = true;
+        for (int v = 0; v < n; v++) {
+            if (visits[v] != 1) once = false;
+        }
+        CHECK(once == true);
+    }
+
+    SUBCASE("Exceptions And Nested Loops") {
+        CHECK_THROWS_AS(parallel_for(0, 100000, [](long long begin, long long end) {
+            if (begin <= 777 && 777 < end) throw "Bad index!";
+        }), const char*);
+
+        std::atomic<long long> total(0);
+        parallel_for(0, 64, [&](long long begin, long long end) {
+            for (long long i = begin; i < end; i++) {
+                parallel_for(0, 100, [&](long long b, long long e) { total += e - b; }); // Runs serially
+            }
+        }, 1);
+        CHECK(total.load() == 6400);
+    }
+
+    SUBCASE("Generators On The Pool") {
+        GraphBuilder pool_builder, serial_builder;
+        generateBarabasiAlbert(pool_builder, 20000, 2, 9, 10);
+        generateBarabasiAlbert(serial_builder, 20000, 2, 9, 10, 1);
+        CSRGraph a = pool_builder.buildCSR();
+        CSRGraph b = serial_builder.buildCSR();
+        CHECK(a.getNumEdges() == b.getNumEdges());
+        bool same = true;
+        for (long long i = 0; i < a.getNumEdges(); i++) {
+            if (a.getNeighbors()[i] != b.getNeighbors()[i]) same = false;
+        }
+        CHECK(same == true);
+    }
+
+    setNumThreads(1);
+    CHECK(defaultThreadPool().size() == 1);
+    std::atomic<int> calls(0);
+    parallel_for(0, 1000, [&](long long, long long) { calls++; });
+    CHECK(calls.load() == 1);       // One thread: a single serial call
+    setNumThreads(0);
+    CHECK(getNumThreads() >= 1);
+}
+
+
+TEST_CASE("Batched Dijkstra Tests") {
+    SUBCASE("Small Graph") {
+        Graph g(5);
+        g.addEdge(0, 1, 4);
+        g.addEdge(0, 2, 1);
+        g.addEdge(2, 1, 2);
+        g.addEdge(1, 3, 5);
+        Algorithms alg(g);
+        int sources[3] = {0, 3, 4};
+        int dist[15];
+        alg.dijkstraBatch(sources, 3, dist);
+        const int X = DIST_INF;
+        int expected[15] = {0, 3, 1, 8, X,      // From 0
+                            8, 5, 7, 0, X,      // From 3
+                            X, X, X, X, 0};     // From the isolated vertex 4
+        for (int i = 0; i < 15; i++) {
+            CHECK(dist[i] == expected[i]);
+        }
+        alg.dijkstraBatch(sources, 0, dist);    // Nothing to do
+        int invalid[1] = {5};
+        CHECK_THROWS_AS(alg.dijkstraBatch(invalid, 1, dist), const char*);
+        CHECK_THROWS_AS(alg.dijkstraBatch(sources, -1, dist), const char*);
+        g.addEdge(3, 4, -1);
+        CHECK_THROWS_AS(alg.dijkstraBatch(sources, 3, dist), const char*);
+    }
+
+    SUBCASE("Matches Single Source Queries") {
+        // A random graph keeps wide groups after the probe, a grid runs the rest one by one
+        for (int kind = 0; kind < 2; kind++) {
+            GraphBuilder builder;
+            if (kind == 0) generateErdosRenyi(builder, 300, 1200, 7, 50);
+            else generateGrid(builder, 15, 20, 7, 50);
+            CSRGraph csr = builder.buildCSR();
+            int n = csr.getNumVertices();
+            const int K = 80;                   // Probe group plus more than one full group
+            std::vector<int> sources(K);
+            for (int q = 0; q < K; q++) sources[q] = (q * 37) % n;
+            std::vector<int> dist((size_t)K * n);
+            BasicAlgorithms<CSRGraph> alg(csr);
+            alg.dijkstraBatch(sources.data(), K, dist.data());
+
+            QueryEngine engine(builder.buildCSR(), 1);
+            std::vector<int> single(n);
+            int mismatches = 0;
+            for (int q = 0; q < K; q++) {
+                engine.dijkstra(sources[q], single.data());
+                for (int v = 0; v < n; v++) {
+                    if (dist[(size_t)q * n + v] != single[v]) mismatches++;
+                }
+            }
+            CHECK(mismatches == 0);
+        }
+    }
+}
+
+
+TEST_CASE("All Pairs Shortest Paths Tests") {
+    SUBCASE("Small Graphs") {
+        Graph g(4);
+        g.addEdge(0, 1, 4);
+        g.addEdge(0, 2, 1);
+        g.addEdge(2, 1, 2);
+        int expected[16] = {0, 3, 1, DIST_INF,
+                            3, 0, 2, DIST_INF,
+                            1, 2, 0, DIST_INF,
+                            DIST_INF, DIST_INF, DIST_INF, 0};
+        int dist[16];
+        APSPMethod methods[3] = {APSP_AUTO, APSP_FLOYD_WARSHALL, APSP_DIJKSTRA};
+        for (APSPMethod method : methods) {
+            allPairsShortestPaths(g, dist, method);
+            for (int i = 0; i < 16; i++) {
+                CHECK(dist[i] == expected[i]);
+            }
+        }
+
+        GraphBuilder builder(3);                    // Directed, with a negative arc
+        builder.addEdge(0, 1, 5);
+        builder.addEdge(1, 2, -3);
+        builder.addEdge(0, 2, 4);
+        CSRGraph directed = builder.buildCSR(false);
+        CHECK(chooseAPSPMethod(directed) == APSP_FLOYD_WARSHALL);
+        int small[9];
+        allPairsShortestPaths(directed, small);
+        CHECK(small[0 * 3 + 2] == 2);
+        CHECK(small[1 * 3 + 2] == -3);
+        CHECK(small[2 * 3 + 0] == DIST_INF);
+        CHECK_THROWS_AS(allPairsShortestPaths(directed, small, APSP_DIJKSTRA), const char*);
+        builder.addEdge(2, 0, 1);                   // Cycle 0 -> 1 -> 2 -> 0 of weight 3
+        CSRGraph positiveCycle = builder.buildCSR(false);
+        allPairsShortestPaths(positiveCycle, small);
+        CHECK(small[2 * 3 + 1] == 6);
+        builder.addEdge(2, 0, -3);                  // Merged as the lighter arc: weight -1
+        CSRGraph negativeCycle = builder.buildCSR(false);
+        CHECK_THROWS_AS(allPairsShortestPaths(negativeCycle, small), const char*);
+    }
+
+    SUBCASE("Backends Agree") {
+        // 300 vertices: two full tiles and a partial one
+        GraphBuilder builder;
+        generateErdosRenyi(builder, 300, 2000, 5, 40);
+        builder.addEdge(299, 298, 1);
+        CSRGraph csr = builder.buildCSR();
+        int n = csr.getNumVertices();
+        std::vector<int> fw((size_t)n * n), dijkstra((size_t)n * n);
+        allPairsShortestPaths(csr, fw.data(), APSP_FLOYD_WARSHALL);
+        allPairsShortestPaths(csr, dijkstra.data(), APSP_DIJKSTRA);
+        CHECK(fw == dijkstra);
+
+        QueryEngine engine(builder.buildCSR(), 1);
+        std::vector<int> single(n);
+        int mismatches = 0;
+        for (int s = 0; s < n; s += 7) {
+            engine.dijkstra(s, single.data());
+            for (int v = 0; v < n; v++) {
+                if (fw[(size_t)s * n + v] != single[v]) mismatches++;
+            }
+        }
+        CHECK(mismatches == 0);
+    }
+}
+
+
+TEST_CASE("Negative Weight Shortest Path Tests") {
+    SUBCASE("Queue Front Operations") {
+        Queue q(2);
+        q.enqueue(1);
+        q.pushFront(0);
+        q.pushFront(-1);                            // Grows
+        q.enqueue(2);
+        CHECK(q.getSize() == 4);
+        CHECK(q.peek() == -1);
+        for (int expected = -1; expected <= 2; expected++) {
+            CHECK(q.dequeue() == expected);
+        }
+        CHECK_THROWS_AS(q.peek(), const char*);
+        q.pushFront(7);                             // Into an empty queue
+        q.enqueue(8);
+        CHECK(q.dequeue() == 7);
+        CHECK(q.dequeue() == 8);
+    }
+
+    SUBCASE("SPFA And Johnson") {
+        // Directed costs with rebates: 0 -> 1 (4), 0 -> 2 (2), 2 -> 1 (-3), 1 -> 3 (1), 3 -> 4 (-2)
+        GraphBuilder builder(6);
+        int src[5] = {0, 0, 2, 1, 3}, dst[5] = {1, 2, 1, 3, 4}, w[5] = {4, 2, -3, 1, -2};
+        builder.appendEdges(src, dst, w, 5);
+        CSRGraph g = builder.buildCSR(false);
+        BasicAlgorithms<CSRGraph> alg(g);
+        int dist[6], parent[6];
+        CHECK(alg.bellmanFord(0, dist, parent) == 5);
+        int expected[6] = {0, -1, 2, 0, -2, DIST_INF};
+        for (int v = 0; v < 6; v++) {
+            CHECK(dist[v] == expected[v]);
+        }
+        CHECK(parent[1] == 2);
+        CHECK(parent[0] == -1);
+        CHECK_THROWS_AS(alg.bellmanFord(6, dist), const char*);
+        CHECK_THROWS_AS(alg.dijkstra(0), const char*);
+
+        int h[6];
+        alg.johnsonPotentials(h);
+        for (int u = 0; u < 5; u++) {
+            CHECK(w[u] + h[src[u]] - h[dst[u]] >= 0);   // Reduced weights are non-negative
+        }
+
+        QueryEngine engine(builder.buildCSR(false), 1);
+        CHECK(engine.hasNegativeWeights() == true);
+        int query[6];
+        CHECK(engine.dijkstra(0, query) == 5);
+        for (int v = 0; v < 6; v++) {
+            CHECK(query[v] == expected[v]);
+        }
+        CHECK(engine.distance(0, 4) == -2);
+        CHECK(engine.distance(2, 1) == -3);
+        CHECK(engine.distance(4, 0) == DIST_INF);
+
+        // h[1] = -1.5e9: the reduced distance 1 -> 3 fits in an int, the original 3e9 does not
+        GraphBuilder large(4);
+        large.addEdge(0, 1, -1500000000);
+        large.addEdge(1, 2, 1500000000);
+        large.addEdge(2, 3, 1500000000);
+        QueryEngine large_engine(large.buildCSR(false), 1);
+        CHECK(large_engine.distance(1, 2) == 1500000000);
+        CHECK_THROWS_AS(large_engine.distance(1, 3), const char*);
+        int tree[4];
+        for (int v = 0; v < 4; v++) query[v] = tree[v] = 42;
+        CHECK_THROWS_AS(large_engine.dijkstra(1, query, tree), const char*);
+        bool untouched = true;              // No mix of reduced and original distances
+        for (int v = 0; v < 4; v++) untouched &= query[v] == 42 && tree[v] == 42;
+        CHECK(untouched);
+        CHECK(large_engine.dijkstra(0, query, tree) == 4);
+        CHECK(query[1] == -1500000000);
+        CHECK(tree[2] == 1);
+        CHECK(large_engine.distance(1, 2) == 1500000000);
+
+        builder.addEdge(4, 2, 1);                   // 2 -> 1 -> 3 -> 4 -> 2 has weight -3
+        CSRGraph cyclic = builder.buildCSR(false);
+        BasicAlgorithms<CSRGraph> cyclic_alg(cyclic);
+        CHECK_THROWS_AS(cyclic_alg.bellmanFord(0, dist), const char*);
+        CHECK(cyclic_alg.bellmanFord(5, dist) == 1); // The cycle is not reachable from 5
+        CHECK_THROWS_AS(cyclic_alg.johnsonPotentials(h), const char*);
+        CHECK_THROWS_AS(QueryEngine(builder.buildCSR(false), 1), const char*);
+    }
+
+    SUBCASE("Matches Dijkstra On Random Graphs") {
+        GraphBuilder builder;
+        generateErdosRenyi(builder, 500, 3000, 11, 60);
+        CSRGraph csr = builder.buildCSR(false);
+        BasicAlgorithms<CSRGraph> alg(csr);
+        QueryEngine engine(builder.buildCSR(false), 1);
+        std::vector<int> spfa(500), dijkstra(500);
+        int mismatches = 0;
+        for (int s = 0; s < 500; s += 25) {
+            alg.bellmanFord(s, spfa.data());
+            engine.dijkstra(s, dijkstra.data());
+            for (int v = 0; v < 500; v++) {
+                if (spfa[v] != dijkstra[v]) mismatches++;
+            }
+        }
+        CHECK(mismatches == 0);
+
+        // Negative weights without cycles: arcs only go from lower to higher ids
+        GraphBuilder dag(300);
+        for (int e = 0; e < 2000; e++) {
+            int u = (e * 7919) % 300, v = (e * 104729 + 13) % 300;
+            if (u == v) continue;
+            dag.addEdge(u < v ? u : v, u < v ? v : u, (e * 31) % 50 - 20);
+        }
+        CSRGraph dag_csr = dag.buildCSR(false);
+        std::vector<int> matrix(300 * 300);
+        allPairsShortestPaths(dag_csr, matrix.data(), APSP_FLOYD_WARSHALL);
+        BasicAlgorithms<CSRGraph> dag_alg(dag_csr);
+        QueryEngine dag_engine(dag.buildCSR(false), 1);
+        std::vector<int> row(300), johnson(300);
+        mismatches = 0;
+        for (int s = 0; s < 300; s += 10) {
+            dag_alg.bellmanFord(s, row.data());
+            dag_engine.dijkstra(s, johnson.data());
+            for (int v = 0; v < 300; v++) {
+                int d = matrix[s * 300 + v];
+                if (row[v] != d || johnson[v] != d) mismatches++;
+            }
+        }
+        CHECK(mismatches == 0);
+    }
+}
+
+
+TEST_CASE("Dynamic Shortest Path Tests") {
+    SUBCASE("Updates Repair The Tree") {
+        Graph g(6);
+        g.addEdge(0, 1, 2);
+        g.addEdge(1, 2, 2);
+        g.addEdge(2, 3, 2);
+        g.addEdge(0, 4, 10);
+        DynamicSSSP sssp(g, 0);
+        CHECK(sssp.distance(3) == 6);
+        CHECK(sssp.distance(4) == 10);
+        CHECK(sssp.distance(5) == DIST_INF);
+        CHECK_THROWS_AS(sssp.distance(6), const char*);
+
+        g.addEdge(3, 4, 1);                 // Shortcut to 4
+        CHECK(sssp.distance(4) == 7);
+        CHECK(sssp.getParent(4) == 3);
+        CHECK(sssp.lastRepaired() == 1);
+
+        g.addEdge(0, 2, 5);                 // Longer than 0-1-2: nothing changes
+        CHECK(sssp.lastRepaired() == 0);
+        g.removeEdge(0, 4);                 // Non-tree edge
+        CHECK(sssp.lastRepaired() == 0);
+        CHECK(sssp.distance(4) == 7);
+
+        g.removeEdge(1, 2);                 // 2, 3 and 4 lose their paths, 2 falls back to 0-2
+        CHECK(sssp.lastRepaired() == 3);
+        CHECK(sssp.distance(2) == 5);
+        CHECK(sssp.distance(3) == 7);
+        CHECK(sssp.distance(4) == 8);
+        CHECK(sssp.getParent(2) == 0);
+
+        g.removeEdge(0, 2);                 // Cuts off 2, 3 and 4
+        CHECK(sssp.distance(2) == DIST_INF);
+        CHECK(sssp.distance(4) == DIST_INF);
+        CHECK(sssp.getParent(3) == -1);
+        g.addEdge(1, 4, 3);                 // A weight change is a remove and an add
+        CHECK(sssp.distance(2) == 8);
+        g.removeEdge(1, 4);
+        g.addEdge(1, 4, 1);
+        CHECK(sssp.distance(2) == 6);
+        CHECK(sssp.distance(3) == 4);
+
+        g.addEdge(0, 3, 4);                 // Same length as 0-1-4-3: the tree edge can go
+        g.removeEdge(3, 4);
+        CHECK(sssp.lastRepaired() == 0);
+        CHECK(sssp.distance(3) == 4);
+
+        // A rejected edge leaves the graph and every observer untouched
+        DynamicConnectivity connectivity(g);
+        int before = sssp.distance(5);
+        int sizeBefore = g.getSize(0);
+        CHECK_THROWS_AS(g.addEdge(0, 5, -1), const char*);
+        CHECK(g.getSize(0) == sizeBefore);
+        CHECK(g.getSize(5) == 0);
+        CHECK(sssp.distance(5) == before);
+        CHECK(connectivity.connected(0, 5) == (before != DIST_INF));
+        g.addEdge(0, 5, 1);                 // The edge can still be added with a valid weight
+        CHECK(sssp.distance(5) == 1);
+        CHECK(connectivity.connected(0, 5) == true);
+        Graph negative(2);
+        negative.addEdge(0, 1, -1);
+        CHECK_THROWS_AS(DynamicSSSP(negative, 0), const char*);
+        CHECK_THROWS_AS(DynamicSSSP(g, 6), const char*);
+    }
+
+    SUBCASE("Observers Follow The Object") {
+        Graph g(4);
+        g.addEdge(0, 1, 1);
+        {
+            DynamicSSSP first(g, 0);
+            DynamicSSSP second(g, 1);
+            Graph copy = g;                 // Copies are not observed
+            copy.addEdge(1, 2, 1);
+            CHECK(first.distance(2) == DIST_INF);
+            g.addEdge(1, 2, 1);
+            CHECK(first.distance(2) == 2);
+            CHECK(second.distance(2) == 1);
+        }
+        g.addEdge(2, 3, 1);                 // Both detached on destruction
+        DynamicSSSP hops(g, 3);
+        UnweightedGraph u(3);
+        BasicDynamicSSSP<UnweightedGraph> unit(u, 0);
+        u.addEdge(0, 1, 7);
+        u.addEdge(1, 2);
+        CHECK(unit.distance(2) == 2);
+        CHECK(hops.distance(0) == 3);
+
+        // Assignment would replace the storage under the observers: rejected, nothing changes
+        Graph other(100);
+        CHECK_THROWS_AS(g = other, const char*);
+        CHECK_THROWS_AS(g = Graph(100), const char*);
+        CHECK_THROWS_AS(other = std::move(g), const char*);
+        CHECK(g.getNumVertices() == 4);
+        CHECK(other.getNumVertices() == 100);
+        g.removeEdge(0, 1);
+        CHECK(hops.distance(0) == DIST_INF);
+        Graph plain(2);
+        plain = other;                      // Unobserved graphs still assign
+        CHECK(plain.getNumVertices() == 100);
+    }
+
+    SUBCASE("Matches Recomputation On Random Updates") {
+        const int n = 300;
+        GraphBuilder builder(n);
+        generateErdosRenyi(builder, n, 900, 5, 10);
+        CSRGraph csr = builder.buildCSR();
+        InterleavedGraph g(n, csr.getOffsets(), csr.getNeighbors(), csr.getWeights());
+        BasicDynamicSSSP<InterleavedGraph> sssp(g, 0);
+        BasicAlgorithms<InterleavedGraph> alg(g);
+        std::vector<int> expected(n);
+        int mismatches = 0;
+        long long repaired = 0;
+        unsigned long long state = 12345;
+        for (int step = 0; step < 2000; step++) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            int u = (int)((state >> 33) % n), v = (int)((state >> 13) % n);
+            if (u == v) continue;
+            bool present = false;
+            for (Edge e : g.edges(u)) present |= e.dst == v;
+            if (present) g.removeEdge(u, v);
+            else g.addEdge(u, v, (int)((state >> 45) % 6)); // Zero weights make ties
+            repaired += sssp.lastRepaired();
+            if (step % 50 == 0) {
+                int source = 0;
+                alg.dijkstraBatch(&source, 1, expected.data());
+                for (int x = 0; x < n; x++) {
+                    if (sssp.distance(x) != expected[x]) mismatches++;
+                    int p = sssp.getParent(x);  // The tree uses edges on shortest paths
+                    if (p != -1) {
+                        int w = -1;
+                        for (Edge e : g.edges(x)) if (e.dst == p) w = e.w;
+                        if (w < 0 || expected[p] + w != expected[x]) mismatches++;
+                    }
+                }
+            }
+        }
+        CHECK(mismatches == 0);
+        CHECK(repaired < 2000LL * n / 10);   // Updates touch a small part of the graph
+    }
+}
+
+
+TEST_CASE("Dynamic MST Tests") {
+    SUBCASE("Link Cut Tree") {
+        LinkCutTree lct(6);
+        lct.link(0, 1);
+        lct.link(1, 2);
+        lct.link(3, 2);
+        lct.setValue(1, 5);
+        lct.setValue(3, 7);
+        CHECK(lct.connected(0, 3));
+        CHECK_FALSE(lct.connected(0, 4));
+        CHECK(lct.pathMax(0, 2) == 1);
+        CHECK(lct.pathMax(3, 0) == 3);
+        CHECK(lct.pathMax(0, 5) == -1);
+        CHECK(lct.getValue(4) == INT_MIN);
+        CHECK_THROWS_AS(lct.link(0, 3), const char*);
+        CHECK_THROWS_AS(lct.cut(0, 2), const char*);
+        lct.cut(2, 1);
+        CHECK_FALSE(lct.connected(0, 3));
+        CHECK(lct.pathMax(2, 3) == 3);
+        lct.link(2, 4);
+        lct.link(0, 4);             // Any node can be linked: the tree is re-rooted
+        CHECK(lct.pathMax(1, 3) == 3);
+        CHECK_THROWS_AS(lct.link(6, 0), const char*);
+        lct.setValue(2, INT_MIN);                   // Set nodes win ties against unset ones
+        CHECK(lct.pathMax(0, 2) == 2);
+    }
+
+    SUBCASE("Minimum Weight Edges") {
+        Graph g(3);                 // Edge nodes must beat vertex nodes (also INT_MIN) in pathMax
+        DynamicMST mst(g);
+        g.addEdge(0, 1, INT_MIN);
+        g.addEdge(1, 2, INT_MIN);
+        g.addEdge(2, 0, INT_MIN);
+        CHECK(mst.numTreeEdges() == 2);
+        CHECK(mst.totalWeight() == 2LL * INT_MIN);
+        g.removeEdge(0, 1);
+        CHECK(mst.numTreeEdges() == 2);
+        CHECK(mst.inForest(2, 0));
+    }
+
+    SUBCASE("Updates Keep A Minimum Forest") {
+        Graph g(5);
+        g.addEdge(0, 1, 4);
+        g.addEdge(1, 2, 2);
+        g.addEdge(0, 2, 3);
+        DynamicMST mst(g);
+        CHECK(mst.totalWeight() == 5);
+        CHECK(mst.numTreeEdges() == 2);
+        CHECK(mst.numComponents() == 3);
+        CHECK_FALSE(mst.inForest(0, 1));
+        CHECK(mst.inForest(2, 0));
+
+        g.addEdge(0, 1, 1);         // Can't: the edge exists, weights change by remove + add
+        CHECK(mst.totalWeight() == 5);
+        g.removeEdge(0, 1);         // Non-tree edge
+        CHECK(mst.lastReplacementScan() == 0);
+        g.addEdge(0, 1, 1);         // Replaces 0 - 2, the heaviest edge of cycle 0 - 1 - 2
+        CHECK(mst.totalWeight() == 3);
+        CHECK_FALSE(mst.inForest(0, 2));
+
+        g.addEdge(2, 3, 6);
+        g.addEdge(3, 4, 1);
+        g.addEdge(1, 4, 9);
+        CHECK(mst.totalWeight() == 10);
+        CHECK(mst.numComponents() == 1);
+        g.removeEdge(2, 3);         // 1 - 4 is the only way back to {3, 4}
+        CHECK(mst.totalWeight() == 13);
+        CHECK(mst.inForest(4, 1));
+        g.removeEdge(1, 4);         // No replacement: the forest splits
+        CHECK(mst.numComponents() == 2);
+        CHECK_FALSE(mst.connected(0, 3));
+        CHECK(mst.connected(3, 4));
+        CHECK(getTotalWeight(mst.forest()) == mst.totalWeight());
+        CHECK_THROWS_AS(mst.inForest(0, 5), const char*);
+    }
+
+    SUBCASE("Matches Kruskal On Random Updates") {
+        const int n = 120;
+        GraphBuilder builder(n);
+        generateErdosRenyi(builder, n, 300, 17, 20);
+        Graph g = builder.buildGraph<Weighted>();
+        DynamicMST mst(g);
+        Algorithms alg(g);
+        std::vector<int> component(n);
+        auto forestWeight = [&]() {         // Kruskal over a forest (kruskal() needs a connected graph)
+            std::vector<std::pair<int, std::pair<int, int>>> edges;
+            for (int u = 0; u < n; u++) {
+                for (Edge e : g.edges(u)) {
+                    if (u < e.dst) edges.push_back({e.w, {u, e.dst}});
+                }
+            }
+            std::sort(edges.begin(), edges.end());
+            UnionFind uf(n);
+            long long total = 0;
+            for (auto& edge : edges) {
+                if (uf.find(edge.second.first) != uf.find(edge.second.second)) {
+                    uf.unionSets(edge.second.first, edge.second.second);
+                    total += edge.first;
+                }
+            }
+            return total;
+        };
+        int mismatches = 0;
+        unsigned long long state = 777;
+        for (int step = 0; step < 1500; step++) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            int u = (int)((state >> 33) % n), v = (int)((state >> 13) % n);
+            if (u == v) continue;
+            bool present = false;
+            for (Edge e : g.edges(u)) present |= e.dst == v;
+            if (present) g.removeEdge(u, v);
+            else g.addEdge(u, v, (int)((state >> 45) % 41) - 10); // Negative weights are fine
+            if (step % 25 == 0) {
+                if (forestWeight() != mst.totalWeight()) mismatches++;
+                if (alg.connectedComponents(component.data()) != mst.numComponents()) mismatches++;
+                if (getTotalWeight(mst.forest()) != mst.totalWeight()) mismatches++;
+            }
+        }
+        CHECK(mismatches == 0);
+    }
+}
+
+
+TEST_CASE("Dynamic Connectivity Tests") {
+    SUBCASE("Edge Map") {
+        EdgeMap map(2);
+        for (int i = 0; i < 100; i++) {
+            map.insert(i, i + 1, i);
+        }
+        CHECK(map.size() == 100);
+        CHECK(map.find(41, 40) == 40);     // Pairs are unordered
+        CHECK(map.find(0, 2) == -1);
+        CHECK_THROWS_AS(map.insert(1, 0, 7), const char*);
+        for (int i = 0; i < 100; i += 2) {
+            CHECK(map.erase(i + 1, i));
+        }
+        CHECK_FALSE(map.erase(0, 1));
+        int found = 0;
+        for (int i = 0; i < 100; i++) {
+            found += map.find(i, i + 1) == (i % 2 ? i : -1);
+        }
+        CHECK(found == 100);
+    }
+
+    SUBCASE("Updates And Queries") {
+        Graph g(6);
+        g.addEdge(0, 1);
+        g.addEdge(1, 2);
+        g.addEdge(2, 0);
+        g.addEdge(3, 4);
+        DynamicConnectivity dc(g);
+        CHECK(dc.numComponents() == 3);
+        CHECK(dc.connected(0, 2));
+        CHECK_FALSE(dc.connected(0, 3));
+        CHECK(dc.componentSize(1) == 3);
+        CHECK(dc.componentSize(5) == 1);
+
+        g.removeEdge(0, 1);         // The triangle still connects 0 and 1
+        CHECK(dc.connected(0, 1));
+        g.removeEdge(1, 2);
+        CHECK_FALSE(dc.connected(0, 1));
+        CHECK(dc.numComponents() == 4);
+        g.addEdge(1, 4);
+        g.addEdge(2, 3);
+        CHECK(dc.connected(0, 4));
+        CHECK(dc.componentSize(3) == 5);
+        g.removeEdge(3, 4);         // 0 - 2 - 3 and 1 - 4
+        CHECK(dc.connected(0, 3));
+        CHECK_FALSE(dc.connected(3, 4));
+        CHECK(dc.numComponents() == 3);
+        CHECK_THROWS_AS(dc.connected(0, 6), const char*);
+    }
+
+    SUBCASE("Matches Components On Random Updates") {
+        const int n = 200;
+        GraphBuilder builder(n);
+        generateErdosRenyi(builder, n, 220, 23);
+        UnweightedGraph g = builder.buildGraph<Unweighted>();
+        BasicDynamicConnectivity<UnweightedGraph> dc(g);
+        BasicAlgorithms<UnweightedGraph> alg(g);
+        std::vector<int> component(n);
+        int mismatches = 0;
+        unsigned long long state = 99;
+        for (int step = 0; step < 4000; step++) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            int u = (int)((state >> 33) % n), v = (int)((state >> 13) % n);
+            if (u == v) continue;
+            bool present = false;
+            for (Edge e : g.edges(u)) present |= e.dst == v;
+            // Keep the graph near the connectivity threshold, where deletions split trees
+            if (present) g.removeEdge(u, v);
+            else if ((state >> 50) % 4 != 0 || step < 200) g.addEdge(u, v);
+            if (step % 40 == 0) {
+                int count = alg.connectedComponents(component.data());
+                if (count != dc.numComponents()) mismatches++;
+                for (int q = 0; q < 50; q++) {
+                    int a = (q * 37 + step) % n, b = (q * 91 + 7 * step) % n;
+                    if (dc.connected(a, b) != (component[a] == component[b])) mismatches++;
+                }
+            }
+        }
+        CHECK(mismatches == 0);
+    }
+}
+
+
+TEST_CASE("Offline Connectivity Tests") {
+    SUBCASE("Rollback Union Find") {
+        RollbackUnionFind uf(6);
+        CHECK(uf.unionSets(0, 1));
+        int snapshot = uf.snapshot();
+        CHECK(uf.unionSets(2, 3));
+        CHECK(uf.unionSets(1, 3));
+        CHECK_FALSE(uf.unionSets(0, 2));
+        CHECK(uf.find(0) == uf.find(3));
+        CHECK(uf.numComponents() == 3);
+        uf.rollback(snapshot);
+        CHECK(uf.find(0) == uf.find(1));
+        CHECK(uf.find(1) != uf.find(3));
+        CHECK(uf.find(2) != uf.find(3));
+        CHECK(uf.numComponents() == 5);
+        CHECK(uf.unionSets(3, 4));          // Still consistent after the rollback
+        CHECK(uf.find(4) == uf.find(3));
+        uf.rollback(0);
+        CHECK(uf.numComponents() == 6);
+        CHECK_THROWS_AS(uf.rollback(1), const char*);
+        CHECK_THROWS_AS(uf.find(6), const char*);
+    }
+
+    SUBCASE("Answers In Order") {
+        Graph g(5);
+        g.addEdge(0, 1);
+        OfflineOp ops[] = {
+            {OFFLINE_CONNECTED, 0, 1},
+            {OFFLINE_ADD, 1, 2},
+            {OFFLINE_CONNECTED, 0, 2},
+            {OFFLINE_COMPONENTS, 0, 0},
+            {OFFLINE_REMOVE, 1, 0},
+            {OFFLINE_CONNECTED, 0, 2},
+            {OFFLINE_ADD, 3, 4},
+            {OFFLINE_ADD, 4, 3},            // Already present: ignored
+            {OFFLINE_REMOVE, 3, 4},
+            {OFFLINE_COMPONENTS, 0, 0},
+        };
+        int answers[5];
+        CHECK(offlineConnectivity(g, ops, 10, answers) == 5);
+        CHECK(answers[0] == 1);
+        CHECK(answers[1] == 1);
+        CHECK(answers[2] == 3);
+        CHECK(answers[3] == 0);
+        CHECK(answers[4] == 4);
+        CHECK(g.getSize(0) == 1);          // The graph itself is untouched
+
+        OfflineOp bad[] = {{OFFLINE_REMOVE, 2, 3}};
+        CHECK_THROWS_AS(offlineConnectivity(g, bad, 1, answers), const char*);
+        OfflineOp loop[] = {{OFFLINE_ADD, 2, 2}};
+        CHECK_THROWS_AS(offlineConnectivity(g, loop, 1, answers), const char*);
+        CHECK(offlineConnectivity(g, ops, 0, answers) == 0);
+    }
+
+    SUBCASE("Matches Dynamic Connectivity") {
+        const int n = 150;
+        GraphBuilder builder(n);
+        generateErdosRenyi(builder, n, 120, 31);
+        CSRGraph start = builder.buildCSR();
+        Graph g = builder.buildGraph<Weighted>();
+        DynamicConnectivity dc(g);
+        std::vector<OfflineOp> ops;
+        std::vector<int> expected;
+        unsigned long long state = 4242;
+        for (int step = 0; step < 5000; step++) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            int u = (int)((state >> 33) % n), v = (int)((state >> 13) % n);
+            int kind = (int)((state >> 50) % 8);
+            if (u == v) continue;
+            bool present = false;
+            for (Edge e : g.edges(u)) present |= e.dst == v;
+            if (kind < 3) {
+                ops.push_back({present ? OFFLINE_REMOVE : OFFLINE_ADD, u, v});
+                if (present) g.removeEdge(u, v);
+                else g.addEdge(u, v);
+            } else if (kind < 7) {
+                ops.push_back({OFFLINE_CONNECTED, u, v});
+                expected.push_back(dc.connected(u, v) ? 1 : 0);
+            } else {
+                ops.push_back({OFFLINE_COMPONENTS, 0, 0});
+                expected.push_back(dc.numComponents());
+            }
+        }
+        std::vector<int> answers(expected.size());
+        CHECK(offlineConnectivity(start, ops.data(), (int)ops.size(), answers.data()) == (int)expected.size());
+        CHECK(answers == expected);
+    }
+}
+
+
+TEST_CASE("PageRank Tests") {
+    // Straightforward double precision power iteration over the out-edges
+    auto reference = [](const CSRGraph& g, const std::vector<double>& restart, std::vector<double>& rank) {
+        int n = g.getNumVertices();
+        rank = restart;
+        for (int it = 0; it < 200; it++) {
+            std::vector<double> next(n, 0.0);
+            double danglingMass = 0.0;
+            for (int u = 0; u < n; u++) {
+                if (g.getSize(u) == 0) danglingMass += rank[u];
+                for (Edge e : g.edges(u)) next[e.dst] += 0.85 * rank[u] / g.getSize(u);
+            }
+            for (int v = 0; v < n; v++) next[v] += (0.15 + 0.85 * danglingMass) * restart[v];
+            rank = next;
+        }
+    };
+
+    SUBCASE("Symmetric And Directed Graphs") {
+        Graph star(5);
+        for (int v = 1; v < 5; v++) star.addEdge(0, v);
+        PageRank starRank(star);
+        std::vector<float> rank(5);
+        CHECK(starRank.run(rank.data()) > 1);
+        CHECK(rank[0] > 0.4f);
+        CHECK(rank[1] == doctest::Approx(rank[4]));
+        double sum = 0;
+        for (float r : rank) sum += r;
+        CHECK(sum == doctest::Approx(1.0).epsilon(1e-4));
+
+        GraphBuilder builder(4);            // 3 is dangling
+        builder.addEdge(0, 1);
+        builder.addEdge(1, 2);
+        builder.addEdge(2, 0);
+        builder.addEdge(2, 3);
+        CSRGraph directed = builder.buildCSR(false);
+        PageRank engine(directed);
+        engine.run(rank.data(), 0.85f, 1e-7f);
+        std::vector<double> expected;
+        reference(directed, std::vector<double>(4, 0.25), expected);
+        for (int v = 0; v < 4; v++) {
+            CHECK(rank[v] == doctest::Approx(expected[v]).epsilon(1e-4));
+        }
+        CHECK(engine.run(rank.data(), 0.85f, 0.0f, 3) == 3);   // Stops at maxIterations
+        CHECK_THROWS_AS(engine.run(rank.data(), 1.0f), const char*);
+    }
+
+    SUBCASE("Personalized") {
+        GraphBuilder builder(6);
+        for (int v = 0; v < 5; v++) builder.addEdge(v, v + 1);   // A path
+        CSRGraph path = builder.buildCSR();
+        PageRank engine(path);
+        std::vector<float> rank(6);
+        int seeds[] = {0, 5};
+        float weights[] = {3.0f, 1.0f};
+        engine.runPersonalized(seeds, weights, 2, rank.data(), 0.85f, 1e-7f);
+        std::vector<double> restart(6, 0.0), expected;
+        restart[0] = 0.75;
+        restart[5] = 0.25;
+        reference(path, restart, expected);
+        for (int v = 0; v < 6; v++) {
+            CHECK(rank[v] == doctest::Approx(expected[v]).epsilon(1e-4));
+        }
+        CHECK(rank[0] > rank[5]);
+        CHECK_THROWS_AS(engine.runPersonalized(seeds, nullptr, 0, rank.data()), const char*);
+        int bad[] = {6};
+        CHECK_THROWS_AS(engine.runPersonalized(bad, nullptr, 1, rank.data()), const char*);
+    }
+
+    SUBCASE("Matches Reference On A Random Graph") {
+        GraphBuilder builder;
+        generateRMAT(builder, 10, 8, 3);
+        CSRGraph g = builder.buildCSR(false);
+        int n = g.getNumVertices();
+        std::vector<float> rank(n);
+        std::vector<double> expected;
+        setNumThreads(4);
+        PageRank(g).run(rank.data(), 0.85f, 1e-8f, 200);
+        setNumThreads(0);
+        reference(g, std::vector<double>(n, 1.0 / n), expected);
+        double error = 0;
+        for (int v = 0; v < n; v++) error += std::fabs(rank[v] - expected[v]);
+        CHECK(error < 1e-4);
+    }
+}
+
+
+TEST_CASE("Triangle Counting Tests") {
+    // Per-vertex triangles by checking every triple of an adjacency matrix
+    auto reference = [](const CSRGraph& g, std::vector<long long>& perVertex) {
+        int n = g.getNumVertices();
+        std::vector<char> adjacent((size_t)n * n, 0);
+        for (int u = 0; u < n; u++) {
+            for (Edge e : g.edges(u)) {
+                if (e.dst != u) adjacent[(size_t)u * n + e.dst] = adjacent[(size_t)e.dst * n + u] = 1;
+            }
+        }
+        perVertex.assign(n, 0);
+        long long total = 0;
+        for (int u = 0; u < n; u++) {
+            for (int v = u + 1; v < n; v++) {
+                if (!adjacent[(size_t)u * n + v]) continue;
+                for (int w = v + 1; w < n; w++) {
+                    if (adjacent[(size_t)u * n + w] && adjacent[(size_t)v * n + w]) {
+                        perVertex[u]++;
+                        perVertex[v]++;
+                        perVertex[w]++;
+                        total++;
+                    }
+                }
+            }
+        }
+        return total;
+    };
+
+    SUBCASE("Small Graphs") {
+        Graph g(6);
+        CHECK(countTriangles(g) == 0);
+        for (int u = 0; u < 4; u++) {
+            for (int v = u + 1; v < 4; v++) g.addEdge(u, v);     // K4
+        }
+        g.addEdge(3, 4);
+        long long perVertex[6];
+        CHECK(countTriangles(g, perVertex) == 4);
+        CHECK(perVertex[0] == 3);
+        CHECK(perVertex[3] == 3);
+        CHECK(perVertex[4] == 0);
+        double coefficients[6];
+        double average = clusteringCoefficients(g, coefficients);
+        CHECK(coefficients[0] == doctest::Approx(1.0));
+        CHECK(coefficients[3] == doctest::Approx(0.5));     // 3 of the 6 pairs of its 4 neighbors
+        CHECK(coefficients[4] == 0.0);
+        CHECK(average == doctest::Approx((3 * 1.0 + 0.5) / 6));
+
+        GraphBuilder builder(3);            // One direction only, a parallel edge and a self-loop
+        builder.addEdge(0, 1);
+        builder.addEdge(1, 2);
+        builder.addEdge(2, 0);
+        builder.addEdge(2, 0, 5);
+        builder.addEdge(1, 1);
+        CHECK(countTriangles(builder.buildCSR(false)) == 1);
+    }
+
+    SUBCASE("Dense And Skewed Graphs") {
+        GraphBuilder complete(40);          // Long lists exercise the block merge
+        for (int u = 0; u < 40; u++) {
+            for (int v = u + 1; v < 40; v++) complete.addEdge(u, v);
+        }
+        CHECK(countTriangles(complete.buildCSR()) == 40 * 39 * 38 / 6);
+
+        GraphBuilder wheel(2001);           // The hub list is much longer than the others (galloping)
+        for (int v = 1; v <= 2000; v++) {
+            wheel.addEdge(0, v);
+            wheel.addEdge(v, v % 2000 + 1);
+        }
+        Graph wheelGraph = wheel.buildGraph<Weighted>();
+        std::vector<long long> perVertex(2001);
+        CHECK(countTriangles(wheelGraph, perVertex.data()) == 2000);
+        CHECK(perVertex[0] == 2000);
+        CHECK(perVertex[17] == 2);
+    }
+
+    SUBCASE("Matches Brute Force On Random Graphs") {
+        for (int kind = 0; kind < 3; kind++) {
+            GraphBuilder builder;
+            if (kind == 0) generateRMAT(builder, 9, 8, 11);
+            else if (kind == 1) generateRandomGeometric(builder, 400, 0.1, 5);
+            else generateBarabasiAlbert(builder, 500, 6, 2);
+            CSRGraph csr = builder.buildCSR();
+            int n = csr.getNumVertices();
+            std::vector<long long> expected, perVertex(n);
+            long long total = reference(csr, expected);
+            CHECK(total > 0);
+            setNumThreads(4);
+            CHECK(countTriangles(csr, perVertex.data()) == total);
+            CHECK(perVertex == expected);
+            CHECK(countTriangles(CompressedGraph(csr)) == total);
+            CHECK(countTriangles(builder.buildGraph<Interleaved>()) == total);
+            setNumThreads(0);
+
+            std::vector<double> coefficients(n);
+            clusteringCoefficients(csr, coefficients.data());
+            double error = 0;
+            for (int v = 0; v < n; v++) {
+                int d = csr.getSize(v);
+                double c = d < 2 ? 0.0 : 2.0 * expected[v] / ((double)d * (d - 1));
+                error += std::fabs(coefficients[v] - c);
+            }
+            CHECK(error < 1e-9);
+        }
+    }
+}
+
+
+TEST_CASE("K-Core Decomposition Tests") {
+    // Every vertex has at most degeneracy neighbors after it in the ordering
+    auto checkOrder = [](const CSRGraph& g, const std::vector<int>& order, int degeneracy) {
+        int n = g.getNumVertices();
+        std::vector<int> position(n, -1);
+        for (int i = 0; i < n; i++) position[order[i]] = i;
+        for (int v = 0; v < n; v++) {
+            if (position[v] == -1) return false;    // Not a permutation
+            int later = 0;
+            for (Edge e : g.edges(v)) {
+                if (position[e.dst] > position[v]) later++;
+            }
+            if (later > degeneracy) return false;
+        }
+        return true;
+    };
+
+    SUBCASE("Small Graph") {
+        Graph g(8);
+        for (int u = 0; u < 4; u++) {
+            for (int v = u + 1; v < 4; v++) g.addEdge(u, v);     // K4: 3-core
+        }
+        g.addEdge(3, 4);
+        g.addEdge(4, 5);
+        g.addEdge(5, 6);
+        g.addEdge(6, 4);                                        // Triangle: 2-core
+        int core[8], order[8];
+        CHECK(coreDecomposition(g, core, order) == 3);
+        int expected[8] = {3, 3, 3, 3, 2, 2, 2, 0};
+        for (int v = 0; v < 8; v++) CHECK(core[v] == expected[v]);
+        CHECK(order[0] == 7);
+        CHECK(parallelCoreDecomposition(g, core) == 3);
+        for (int v = 0; v < 8; v++) CHECK(core[v] == expected[v]);
+        CHECK(coreDecomposition(Graph(0), core) == 0);
+    }
+
+    SUBCASE("Matches Naive Peeling On Random Graphs") {
+        for (int kind = 0; kind < 3; kind++) {
+            GraphBuilder builder;
+            if (kind == 0) generateRMAT(builder, 10, 8, 4);
+            else if (kind == 1) generateBarabasiAlbert(builder, 800, 5, 9);
+            else generateRandomGeometric(builder, 600, 0.08, 1);
+            CSRGraph g = builder.buildCSR();
+            int n = g.getNumVertices();
+
+            // Remove a vertex of minimum degree n times, O(n^2)
+            std::vector<int> degree(n), expected(n);
+            std::vector<bool> removed(n, false);
+            for (int v = 0; v < n; v++) degree[v] = g.getSize(v);
+            int level = 0;
+            for (int step = 0; step < n; step++) {
+                int best = -1;
+                for (int v = 0; v < n; v++) {
+                    if (!removed[v] && (best == -1 || degree[v] < degree[best])) best = v;
+                }
+                level = std::max(level, degree[best]);
+                expected[best] = level;
+                removed[best] = true;
+                for (Edge e : g.edges(best)) degree[e.dst]--;
+            }
+
+            std::vector<int> core(n), order(n);
+            int degeneracy = coreDecomposition(g, core.data(), order.data());
+            CHECK(degeneracy == level);
+            CHECK(core == expected);
+            CHECK(checkOrder(g, order, degeneracy));
+
+            setNumThreads(4);
+            std::fill(core.begin(), core.end(), 0);
+            CHECK(parallelCoreDecomposition(g, core.data(), order.data()) == level);
+            setNumThreads(0);
+            CHECK(core == expected);
+            CHECK(checkOrder(g, order, degeneracy));
+
+            std::vector<int> other(n);
+            coreDecomposition(builder.buildGraph<Unweighted>(), other.data());
+            CHECK(other == expected);
+        }
+    }
 }
 
 